@@ -0,0 +1,70 @@
+/** @file
+ * Zliczanie wywołań funkcji malloc, calloc i realloc. Program trzeba
+ * skonsolidować z opcją -Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc, aby
+ * wszystkie wywołania tych funkcji trafiały do funkcji z tego pliku.
+ *
+ * @author Filip Bieńkowski 407686
+ * @copyright Uniwersytet Warszawski
+ */
+
+#include "AllocationCounter.h"
+
+unsigned long allocations;
+
+/**
+ * @brief Właściwa funkcja malloc
+ * @param size - rozmiar
+ * @return Przydzielona pamięć
+ */
+void *__real_malloc(size_t size);
+
+/**
+ * @brief Właściwa funkcja calloc
+ * @param count - liczba elementów
+ * @param size - rozmiar elementu
+ * @return Przydzielona pamięć
+ */
+void *__real_calloc(size_t count, size_t size);
+
+/**
+ * @brief Właściwa funkcja realloc
+ * @param pointer - powiększana pamięć
+ * @param size - nowy rozmiar
+ * @return Przydzielona pamięć
+ */
+void *__real_realloc(void *pointer, size_t size);
+
+/**
+ * @brief Funkcja malloc, która zlicza wywołania
+ * @param size - rozmiar
+ * @return Przydzielona pamięć
+ */
+void *__wrap_malloc(size_t size)
+{
+    allocations++;
+    return __real_malloc(size);
+}
+
+/**
+ * @brief Funkcja calloc, która zlicza wywołania
+ * @param count - liczba elementów
+ * @param size - rozmiar elementu
+ * @return Przydzielona pamięć
+ */
+void *__wrap_calloc(size_t count, size_t size)
+{
+    allocations++;
+    return __real_calloc(count, size);
+}
+
+/**
+ * @brief Funkcja realloc, która zlicza wywołania
+ * @param pointer - powiększana pamięć
+ * @param size - nowy rozmiar
+ * @return Przydzielona pamięć
+ */
+void *__wrap_realloc(void *pointer, size_t size)
+{
+    allocations++;
+    return __real_realloc(pointer, size);
+}
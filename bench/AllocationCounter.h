@@ -0,0 +1,19 @@
+/** @file
+ * Interfejs zliczania wywołań funkcji przydzielających pamięć
+ *
+ * @author Filip Bieńkowski 407686
+ * @copyright Uniwersytet Warszawski
+ */
+
+#ifndef DROGI_ALLOCATIONCOUNTER_H
+#define DROGI_ALLOCATIONCOUNTER_H
+
+#include <stddef.h>
+
+/**
+ * @brief Liczba wywołań funkcji malloc, calloc i realloc; program może ją
+ * wyzerować przed mierzonym fragmentem
+ */
+extern unsigned long allocations;
+
+#endif //DROGI_ALLOCATIONCOUNTER_H
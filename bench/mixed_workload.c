@@ -0,0 +1,249 @@
+/** @file
+ * Pomiar czasu przeplatanych zmian sieci dróg i wyszukiwań dróg krajowych.
+ * Miasta tworzą kwadratową siatkę. Każdy krok albo usuwa, przywraca lub
+ * remontuje losowy odcinek siatki, albo wyznacza drogę krajową między dwoma
+ * losowymi miastami i ją usuwa. Używa tylko interfejsu z pliku map.h, więc
+ * można go skompilować również ze starszymi wersjami modułu.
+ *
+ * Wywołanie: mixed_workload [bok siatki] [liczba kroków] [procent zmian]
+ * [algorytm], gdzie algorytm to dijkstra, bidirectional, landmarks albo
+ * contraction.
+ *
+ * @author Filip Bieńkowski 407686
+ * @copyright Uniwersytet Warszawski
+ */
+
+#include "map.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+/**
+ * @brief Domyślna liczba miast na boku siatki
+ */
+#define DEFAULT_SIDE 100
+
+/**
+ * @brief Domyślna liczba kroków
+ */
+#define DEFAULT_STEPS 20000
+
+/**
+ * @brief Domyślny procent kroków zmieniających sieć dróg
+ */
+#define DEFAULT_MUTATIONS 50
+
+/**
+ * @brief Rozmiar bufora na nazwę miasta
+ */
+#define NAME_LENGTH 16
+
+/**
+ * @brief Algorytmy, które można wybrać ostatnim argumentem, w kolejności
+ * wartości typu SearchMode
+ */
+static const char *const searchModeNames[] =
+{
+    "dijkstra", "bidirectional", "landmarks", "contraction"
+};
+
+/**
+ * @brief Odcinek siatki
+ */
+struct GridRoad
+{
+    unsigned cityA;  ///< numer pierwszego miasta
+    unsigned cityB;  ///< numer drugiego miasta
+    unsigned length; ///< długość odcinka
+    int year;        ///< rok budowy lub ostatniego remontu
+    bool present;    ///< czy odcinek jest w mapie
+};
+typedef struct GridRoad GridRoad;
+
+/**
+ * @brief Stan generatora liczb pseudolosowych
+ */
+static uint64_t randomState = 0x9E3779B97F4A7C15ULL;
+
+/**
+ * @brief Losuje liczbę z przedziału [0, bound)
+ * @param bound - górne ograniczenie, większe od zera
+ * @return Wylosowana liczba
+ */
+static unsigned nextRandom(unsigned bound)
+{
+    // xorshift64*, so every build runs the same steps
+    randomState ^= randomState >> 12;
+    randomState ^= randomState << 25;
+    randomState ^= randomState >> 27;
+
+    return (unsigned) ((randomState * 0x2545F4914F6CDD1DULL) >> 33) % bound;
+}
+
+/**
+ * @brief Zapisuje nazwę miasta o podanym numerze
+ * @param name - bufor na nazwę
+ * @param city - numer miasta
+ */
+static void cityName(char *name, unsigned city)
+{
+    sprintf(name, "C%u", city);
+}
+
+/**
+ * @brief Dodaje odcinek siatki do mapy
+ * @param map - wskaźnik na mapę
+ * @param road - odcinek
+ * @return false, jeśli nie udało się go dodać; w przeciwnym wypadku true
+ */
+static bool addGridRoad(Map *map, GridRoad *road)
+{
+    char nameA[NAME_LENGTH];
+    char nameB[NAME_LENGTH];
+    cityName(nameA, road->cityA);
+    cityName(nameB, road->cityB);
+
+    road->present = addRoad(map, nameA, nameB, road->length, road->year);
+    return road->present;
+}
+
+/**
+ * @brief Zmienia sieć dróg: usuwa, przywraca lub remontuje losowy odcinek
+ * @param map - wskaźnik na mapę
+ * @param roads - odcinki siatki
+ * @param roadsCount - liczba odcinków siatki
+ */
+static void mutate(Map *map, GridRoad *roads, unsigned roadsCount)
+{
+    GridRoad *road = &roads[nextRandom(roadsCount)];
+    char nameA[NAME_LENGTH];
+    char nameB[NAME_LENGTH];
+    cityName(nameA, road->cityA);
+    cityName(nameB, road->cityB);
+
+    if (!road->present)
+    {
+        addGridRoad(map, road);
+    }
+    else if (nextRandom(4) == 0)
+    {
+        if (repairRoad(map, nameA, nameB, road->year + 1)) road->year++;
+    }
+    else if (removeRoad(map, nameA, nameB))
+    {
+        road->present = false;
+    }
+}
+
+/**
+ * @brief Wyznacza drogę krajową między losowymi miastami i ją usuwa
+ * @param map - wskaźnik na mapę
+ * @param cities - liczba miast
+ * @return true, jeśli drogę udało się wyznaczyć; w przeciwnym wypadku false
+ */
+static bool query(Map *map, unsigned cities)
+{
+    char nameA[NAME_LENGTH];
+    char nameB[NAME_LENGTH];
+    cityName(nameA, nextRandom(cities));
+    cityName(nameB, nextRandom(cities));
+
+    bool found = newRoute(map, 1, nameA, nameB);
+    if (found) removeRoute(map, 1);
+
+    return found;
+}
+
+int main(int argc, char *argv[])
+{
+    unsigned side = argc > 1 ? (unsigned) atoi(argv[1]) : DEFAULT_SIDE;
+    unsigned steps = argc > 2 ? (unsigned) atoi(argv[2]) : DEFAULT_STEPS;
+    unsigned mutations = argc > 3 ? (unsigned) atoi(argv[3])
+                                  : DEFAULT_MUTATIONS;
+    unsigned mode = 0;
+    unsigned modes = sizeof(searchModeNames) / sizeof(searchModeNames[0]);
+
+    while (argc > 4 && mode < modes &&
+           strcmp(argv[4], searchModeNames[mode]) != 0)
+    {
+        mode++;
+    }
+
+    if (side < 2 || mutations > 100 || mode == modes)
+    {
+        fprintf(stderr, "Usage: %s [side >= 2] [steps] [mutations %%] "
+                        "[dijkstra|bidirectional|landmarks|contraction]\n",
+                argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    unsigned cities = side * side;
+    unsigned roadsCount = 2 * side * (side - 1);
+    GridRoad *roads = malloc(sizeof(GridRoad) * roadsCount);
+    Map *map = newMap();
+    if (roads == NULL || map == NULL)
+    {
+        fprintf(stderr, "out of memory\n");
+        return EXIT_FAILURE;
+    }
+    setSearchMode(map, (SearchMode) mode);
+
+    // varied years make ties between shortest paths, which newRoute
+    // rejects, rare
+    unsigned count = 0;
+    for (unsigned row = 0; row < side; ++row)
+    {
+        for (unsigned column = 0; column < side; ++column)
+        {
+            unsigned city = row * side + column;
+            if (column + 1 < side)
+            {
+                roads[count++] = (GridRoad) {city, city + 1,
+                                             1 + nextRandom(9),
+                                             1900 + (int) nextRandom(100),
+                                             false};
+            }
+            if (row + 1 < side)
+            {
+                roads[count++] = (GridRoad) {city, city + side,
+                                             1 + nextRandom(9),
+                                             1900 + (int) nextRandom(100),
+                                             false};
+            }
+        }
+    }
+
+    for (unsigned i = 0; i < roadsCount; ++i)
+    {
+        addGridRoad(map, &roads[i]);
+    }
+
+    unsigned found = 0;
+    unsigned changes = 0;
+    clock_t begin = clock();
+
+    for (unsigned step = 0; step < steps; ++step)
+    {
+        if (nextRandom(100) < mutations)
+        {
+            mutate(map, roads, roadsCount);
+            changes++;
+        }
+        else if (query(map, cities))
+        {
+            found++;
+        }
+    }
+
+    double seconds = (double) (clock() - begin) / CLOCKS_PER_SEC;
+    printf("%u steps (%u changes, %u routes found) in %.3f s, %.1f us/step\n",
+           steps, changes, found, seconds,
+           steps == 0 ? 0.0 : 1e6 * seconds / steps);
+
+    deleteMap(map);
+    free(roads);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,213 @@
+/** @file
+ * Porównanie funkcji hashKey z dawną funkcją haszującą nazwy miast
+ * (h = 31 * h + c, modulo 1009) na nazwach o wspólnych długich przedrostkach.
+ * Dla każdego zbioru nazw mierzy czas haszowania i średnią liczbę porównań
+ * przy wyszukiwaniu nazwy w tablicy kubełków: w dawnym słowniku o 1009
+ * kubełkach oraz, dla obu funkcji, w tablicy o rozmiarze będącym potęgą
+ * dwójki, co najmniej dwa razy większym od liczby nazw. Na koniec mierzy czas
+ * dodawania i remontowania odcinków między miastami o takich nazwach.
+ *
+ * Wywołanie: name_hash [liczba nazw]
+ *
+ * @author Filip Bieńkowski 407686
+ * @copyright Uniwersytet Warszawski
+ */
+
+#include "map.h"
+#include "Dictionary.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/**
+ * @brief Domyślna liczba nazw w każdym zbiorze
+ */
+#define DEFAULT_NAMES 20000
+
+/**
+ * @brief Liczba powtórzeń haszowania całego zbioru nazw
+ */
+#define ROUNDS 50
+
+/**
+ * @brief Liczba kubełków dawnego słownika
+ */
+#define OLD_BUCKETS 1009
+
+/**
+ * @brief Rozmiar bufora na nazwę miasta
+ */
+#define NAME_LENGTH 96
+
+/**
+ * @brief Wzorce nazw kolejnych zbiorów; %u to numer miasta
+ */
+static const char *const patterns[] =
+{
+    "C%u",
+    "Warszawa-Praga-%u",
+    "Gmina-Wiejska-Powiatu-Krakowskiego-Zachodniego-%u",
+};
+
+/**
+ * @brief Dawna funkcja haszująca, bez redukcji modulo
+ * @param key - nazwa
+ * @return Hash nazwy
+ */
+static unsigned oldHash(const char *key)
+{
+    unsigned hash = 0;
+
+    for (; *key != '\0'; key++)
+    {
+        hash = *key + 31 * hash;
+    }
+
+    return hash;
+}
+
+/**
+ * @brief Średnia liczba porównań nazw przy wyszukiwaniu każdej nazwy
+ * w tablicy z listami kubełków
+ * @param buckets - numery kubełków kolejnych nazw
+ * @param count - liczba nazw
+ * @param bucketsCount - liczba kubełków
+ * @return Średnia liczba porównań; 1 oznacza brak kolizji
+ */
+static double averageComparisons(const unsigned *buckets, unsigned count,
+                                 unsigned bucketsCount)
+{
+    unsigned *sizes = calloc(bucketsCount, sizeof(unsigned));
+    if (sizes == NULL) return 0.0;
+
+    // the i-th name of a bucket is found after i comparisons
+    double comparisons = 0.0;
+    for (unsigned i = 0; i < count; ++i)
+    {
+        comparisons += ++sizes[buckets[i]];
+    }
+
+    free(sizes);
+    return comparisons / count;
+}
+
+/**
+ * @brief Mierzy czas haszowania i rozkład nazw jednego zbioru
+ * @param names - nazwy
+ * @param count - liczba nazw
+ * @param pattern - wzorzec nazw, do wypisania
+ * @param buckets - bufor na numery kubełków, count elementów
+ */
+static void compareHashes(char (*names)[NAME_LENGTH], unsigned count,
+                          const char *pattern, unsigned *buckets)
+{
+    volatile unsigned long long sink = 0;
+
+    clock_t begin = clock();
+    for (unsigned round = 0; round < ROUNDS; ++round)
+    {
+        for (unsigned i = 0; i < count; ++i) sink += oldHash(names[i]);
+    }
+    double oldSeconds = (double) (clock() - begin) / CLOCKS_PER_SEC;
+
+    begin = clock();
+    for (unsigned round = 0; round < ROUNDS; ++round)
+    {
+        for (unsigned i = 0; i < count; ++i) sink += hashKey(names[i]);
+    }
+    double newSeconds = (double) (clock() - begin) / CLOCKS_PER_SEC;
+
+    for (unsigned i = 0; i < count; ++i)
+    {
+        buckets[i] = oldHash(names[i]) % OLD_BUCKETS;
+    }
+    double oldComparisons = averageComparisons(buckets, count, OLD_BUCKETS);
+
+    // the dictionary is kept at most 3/4 full, so 2 * count slots is typical
+    unsigned size = 1;
+    while (size < 2 * count) size *= 2;
+
+    for (unsigned i = 0; i < count; ++i)
+    {
+        buckets[i] = oldHash(names[i]) & (size - 1);
+    }
+    double oldSpread = averageComparisons(buckets, count, size);
+
+    // the dictionary starts probing at the high half of the hash
+    for (unsigned i = 0; i < count; ++i)
+    {
+        buckets[i] = (unsigned) (hashKey(names[i]) >> 32) & (size - 1);
+    }
+    double newSpread = averageComparisons(buckets, count, size);
+
+    double hashes = (double) count * ROUNDS;
+    printf("%s\n  old:     %6.1f ns/name, %7.2f cmp in %u buckets, "
+           "%7.2f cmp in %u\n  hashKey: %6.1f ns/name, %28s %7.2f cmp in %u\n",
+           pattern, 1e9 * oldSeconds / hashes, oldComparisons, OLD_BUCKETS,
+           oldSpread, size, 1e9 * newSeconds / hashes, "", newSpread, size);
+}
+
+/**
+ * @brief Mierzy czas dodawania odcinków między miastami o nazwach z jednego
+ * zbioru i wyszukiwania ich przy remontach
+ * @param names - nazwy
+ * @param count - liczba nazw
+ */
+static void measureMap(char (*names)[NAME_LENGTH], unsigned count)
+{
+    Map *map = newMap();
+    if (map == NULL) return;
+
+    clock_t begin = clock();
+    for (unsigned i = 1; i < count; ++i)
+    {
+        addRoad(map, names[i - 1], names[i], 1, 2000);
+    }
+    for (int year = 2001; year <= 2010; ++year)
+    {
+        for (unsigned i = 1; i < count; ++i)
+        {
+            repairRoad(map, names[i - 1], names[i], year);
+        }
+    }
+    double seconds = (double) (clock() - begin) / CLOCKS_PER_SEC;
+
+    printf("  addRoad + 10 x repairRoad: %.3f s\n", seconds);
+    deleteMap(map);
+}
+
+int main(int argc, char *argv[])
+{
+    unsigned count = argc > 1 ? (unsigned) atoi(argv[1]) : DEFAULT_NAMES;
+    if (count < 2)
+    {
+        fprintf(stderr, "Usage: %s [names >= 2]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    char (*names)[NAME_LENGTH] = malloc(sizeof(*names) * count);
+    unsigned *buckets = malloc(sizeof(unsigned) * count);
+    if (names == NULL || buckets == NULL)
+    {
+        fprintf(stderr, "out of memory\n");
+        return EXIT_FAILURE;
+    }
+
+    unsigned patternsCount = sizeof(patterns) / sizeof(patterns[0]);
+    for (unsigned p = 0; p < patternsCount; ++p)
+    {
+        for (unsigned i = 0; i < count; ++i)
+        {
+            snprintf(names[i], NAME_LENGTH, patterns[p], i);
+        }
+
+        compareHashes(names, count, patterns[p], buckets);
+        measureMap(names, count);
+    }
+
+    free(buckets);
+    free(names);
+    return EXIT_SUCCESS;
+}
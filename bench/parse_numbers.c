@@ -0,0 +1,220 @@
+/** @file
+ * Porównanie funkcji tokenToInt i tokenToUnsigned z dawnym odczytem liczb
+ * przez strtol na dwóch milionach liczb drogi krajowej o milionie odcinków
+ * (długość i rok każdego odcinka). Program sprawdza też, czy obie wersje
+ * przyjmują i odrzucają te same wyrazy, na liczbach z drogi i na nietypowych
+ * zapisach liczb.
+ *
+ * Wywołanie: parse_numbers [liczba odcinków]
+ *
+ * @author Filip Bieńkowski 407686
+ * @copyright Uniwersytet Warszawski
+ */
+
+#include "InputReader.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <limits.h>
+#include <time.h>
+
+/**
+ * @brief Domyślna liczba odcinków drogi krajowej
+ */
+#define DEFAULT_HOPS 1000000
+
+/**
+ * @brief Liczba powtórzeń pomiaru; wypisywany jest najlepszy czas
+ */
+#define REPEATS 3
+
+/**
+ * @brief Najdłuższy zapis liczby w wierszu drogi
+ */
+#define NUMBER_LENGTH 12
+
+/**
+ * @brief Nietypowe zapisy liczb, na których obie wersje muszą się zgadzać
+ */
+static const char *const spellings[] =
+{
+    "", "0", "-0", "+0", "1", "-1", "+1", "00000000000000000000012", " 7",
+    "\t-7", " +42", "+-7", "--7", "-", "+", " ", "12a", "1 ", "0x10", "1e3",
+    "2147483647", "2147483648", "-2147483648", "-2147483649", "4294967295",
+    "4294967296", "-4294967295",
+    "9223372036854775807", "9223372036854775808", "-9223372036854775808",
+    "99999999999999999999999",
+};
+
+/**
+ * @brief Stan generatora liczb pseudolosowych
+ */
+static uint64_t randomState = 0x9E3779B97F4A7C15ULL;
+
+/**
+ * @brief Losuje liczbę z przedziału [0, bound)
+ * @param bound - górne ograniczenie, większe od zera
+ * @return Wylosowana liczba
+ */
+static unsigned nextRandom(unsigned bound)
+{
+    // xorshift64*, so every build parses the same numbers
+    randomState ^= randomState >> 12;
+    randomState ^= randomState << 25;
+    randomState ^= randomState >> 27;
+
+    return (unsigned) ((randomState * 0x2545F4914F6CDD1DULL) >> 33) % bound;
+}
+
+/**
+ * @brief Dawny odczyt liczby typu int przez strtol
+ * @param string - napis zakończony znakiem '\0'
+ * @param numerical - tu zapisywana jest odczytana wartość
+ * @return true, jeśli się udało; w przeciwnym wypadku false
+ */
+static bool strtolToInt(char *string, int *numerical)
+{
+    errno = 0;
+    char *lengthIntLastChar;
+    long castCheck = strtol(string, &lengthIntLastChar, 10);
+
+    if (castCheck > INT_MAX || castCheck < INT_MIN) return false;
+
+    if (*lengthIntLastChar != '\0') return false;
+
+    if (errno == ERANGE || errno == EINVAL) return false;
+
+    *numerical = castCheck;
+    return true;
+}
+
+/**
+ * @brief Dawny odczyt liczby typu unsigned przez strtol
+ * @param string - napis zakończony znakiem '\0'
+ * @param numerical - tu zapisywana jest odczytana wartość
+ * @return true, jeśli się udało; w przeciwnym wypadku false
+ */
+static bool strtolToUnsigned(char *string, unsigned *numerical)
+{
+    errno = 0;
+    char *lengthIntLastChar;
+    long castCheck = strtol(string, &lengthIntLastChar, 10);
+
+    if (castCheck > UINT_MAX || castCheck < 0) return false;
+
+    if (*lengthIntLastChar != '\0') return false;
+
+    if (errno == ERANGE || errno == EINVAL) return false;
+
+    *numerical = castCheck;
+    return true;
+}
+
+/**
+ * @brief Sprawdza, czy obie wersje tak samo odczytują wyraz
+ * @param token - wyraz zakończony znakiem '\0'
+ * @return true, jeśli tak; w przeciwnym wypadku false
+ */
+static bool sameResult(Token *token)
+{
+    int oldInt = 0, newInt = 0;
+    unsigned oldUnsigned = 0, newUnsigned = 0;
+
+    bool oldIntRead = strtolToInt(token->text, &oldInt);
+    bool newIntRead = tokenToInt(token, &newInt);
+    bool oldUnsignedRead = strtolToUnsigned(token->text, &oldUnsigned);
+    bool newUnsignedRead = tokenToUnsigned(token, &newUnsigned);
+
+    if (oldIntRead != newIntRead || oldInt != newInt ||
+        oldUnsignedRead != newUnsignedRead || oldUnsigned != newUnsigned)
+    {
+        fprintf(stderr, "different results for \"%s\"\n", token->text);
+        return false;
+    }
+
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    unsigned hops = argc > 1 ? (unsigned) atoi(argv[1]) : DEFAULT_HOPS;
+    if (hops == 0)
+    {
+        fprintf(stderr, "Usage: %s [hops >= 1]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    // lengths go to even tokens and years to odd ones, as in a route line
+    unsigned count = 2 * hops;
+    char *text = malloc(sizeof(char) * NUMBER_LENGTH * count);
+    Token *tokens = malloc(sizeof(Token) * count);
+    if (text == NULL || tokens == NULL)
+    {
+        fprintf(stderr, "out of memory\n");
+        return EXIT_FAILURE;
+    }
+
+    for (unsigned i = 0; i < count; ++i)
+    {
+        tokens[i].text = text + (size_t) i * NUMBER_LENGTH;
+        int written = i % 2 == 0
+                      ? sprintf(tokens[i].text, "%u", 1 + nextRandom(1000000))
+                      : sprintf(tokens[i].text, "%d",
+                                (int) nextRandom(4000) - 2000);
+        tokens[i].length = (size_t) written;
+    }
+
+    bool same = true;
+    for (unsigned i = 0; i < count; ++i)
+    {
+        same = sameResult(&tokens[i]) && same;
+    }
+
+    unsigned spellingsCount = sizeof(spellings) / sizeof(spellings[0]);
+    for (unsigned i = 0; i < spellingsCount; ++i)
+    {
+        char copy[64];
+        strcpy(copy, spellings[i]);
+        Token token = {copy, strlen(copy)};
+        same = sameResult(&token) && same;
+    }
+
+    double oldBest = -1.0, newBest = -1.0;
+    volatile long long sink = 0;
+
+    for (unsigned repeat = 0; repeat < REPEATS; ++repeat)
+    {
+        unsigned length;
+        int year;
+
+        clock_t begin = clock();
+        for (unsigned i = 0; i < count; i += 2)
+        {
+            if (strtolToUnsigned(tokens[i].text, &length)) sink += length;
+            if (strtolToInt(tokens[i + 1].text, &year)) sink += year;
+        }
+        double seconds = (double) (clock() - begin) / CLOCKS_PER_SEC;
+        if (oldBest < 0 || seconds < oldBest) oldBest = seconds;
+
+        begin = clock();
+        for (unsigned i = 0; i < count; i += 2)
+        {
+            if (tokenToUnsigned(&tokens[i], &length)) sink += length;
+            if (tokenToInt(&tokens[i + 1], &year)) sink += year;
+        }
+        seconds = (double) (clock() - begin) / CLOCKS_PER_SEC;
+        if (newBest < 0 || seconds < newBest) newBest = seconds;
+    }
+
+    printf("%u numbers: strtol %.1f ms, "
+           "tokenToInt/tokenToUnsigned %.1f ms%s\n",
+           count, 1e3 * oldBest, 1e3 * newBest,
+           same ? "" : " (results differ)");
+
+    free(tokens);
+    free(text);
+    return same ? EXIT_SUCCESS : EXIT_FAILURE;
+}
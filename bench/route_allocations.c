@@ -0,0 +1,94 @@
+/** @file
+ * Liczba przydziałów pamięci przy budowie długich dróg krajowych. Program
+ * tworzy drogę krajową z opisu przez n - 1 wywołań extendCustomRoute, a potem
+ * wyznacza funkcją newRoute drugą drogę krajową przez te same n miast.
+ * Wywołania malloc, calloc i realloc liczy moduł AllocationCounter. Używa
+ * tylko interfejsu z pliku map.h, więc można go skompilować również ze
+ * starszymi wersjami modułu.
+ *
+ * Wywołanie: route_allocations [liczba miast]
+ *
+ * @author Filip Bieńkowski 407686
+ * @copyright Uniwersytet Warszawski
+ */
+
+#include "map.h"
+#include "AllocationCounter.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/**
+ * @brief Domyślna liczba miast drogi krajowej
+ */
+#define DEFAULT_CITIES 10000
+
+/**
+ * @brief Rozmiar bufora na nazwę miasta
+ */
+#define NAME_LENGTH 16
+
+/**
+ * @brief Zapisuje nazwę miasta o podanym numerze
+ * @param name - bufor na nazwę
+ * @param city - numer miasta
+ */
+static void cityName(char *name, unsigned city)
+{
+    sprintf(name, "C%u", city);
+}
+
+int main(int argc, char *argv[])
+{
+    unsigned cities = argc > 1 ? (unsigned) atoi(argv[1]) : DEFAULT_CITIES;
+    if (cities < 2)
+    {
+        fprintf(stderr, "Usage: %s [cities >= 2]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    Map *map = newMap();
+    if (map == NULL)
+    {
+        fprintf(stderr, "out of memory\n");
+        return EXIT_FAILURE;
+    }
+
+    char name[NAME_LENGTH];
+    char last[NAME_LENGTH];
+    cityName(name, 0);
+
+    allocations = 0;
+    clock_t begin = clock();
+    if (newCustomRoute(map, 1, name) == NULL)
+    {
+        fprintf(stderr, "newCustomRoute failed\n");
+        return EXIT_FAILURE;
+    }
+    for (unsigned i = 1; i < cities; ++i)
+    {
+        cityName(name, i);
+        if (!extendCustomRoute(map, 1, 1, 2000, name))
+        {
+            fprintf(stderr, "extendCustomRoute failed at city %u\n", i);
+            return EXIT_FAILURE;
+        }
+    }
+    double seconds = (double) (clock() - begin) / CLOCKS_PER_SEC;
+    printf("extendCustomRoute x %u: %lu allocations, %.3f s\n",
+           cities - 1, allocations, seconds);
+
+    cityName(name, 0);
+    cityName(last, cities - 1);
+
+    allocations = 0;
+    begin = clock();
+    bool found = newRoute(map, 2, name, last);
+    seconds = (double) (clock() - begin) / CLOCKS_PER_SEC;
+    printf("newRoute through %u cities: %lu allocations, %.3f s%s\n",
+           cities, allocations, seconds, found ? "" : " (failed)");
+
+    deleteMap(map);
+    return found ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,146 @@
+/** @file
+ * Czas i liczba przydziałów pamięci funkcji getRouteDescription dla drogi
+ * krajowej przez wiele miast. Przed każdym opisem remontowany jest inny
+ * odcinek drogi, więc opis nie może zostać wzięty z pamięci podręcznej; dla
+ * porównania mierzone są też opisy bez remontów.
+ * Wywołania malloc, calloc i realloc liczy moduł AllocationCounter. Używa
+ * tylko interfejsu z pliku map.h, więc można go skompilować również ze
+ * starszymi wersjami modułu.
+ *
+ * Wywołanie: route_description [liczba miast] [liczba opisów]
+ *
+ * @author Filip Bieńkowski 407686
+ * @copyright Uniwersytet Warszawski
+ */
+
+#include "map.h"
+#include "AllocationCounter.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/**
+ * @brief Domyślna liczba miast drogi krajowej
+ */
+#define DEFAULT_CITIES 10000
+
+/**
+ * @brief Domyślna liczba opisów
+ */
+#define DEFAULT_DESCRIPTIONS 200
+
+/**
+ * @brief Rozmiar bufora na nazwę miasta
+ */
+#define NAME_LENGTH 32
+
+/**
+ * @brief Zapisuje nazwę miasta o podanym numerze
+ * @param name - bufor na nazwę
+ * @param city - numer miasta
+ */
+static void cityName(char *name, unsigned city)
+{
+    sprintf(name, "Miasto-%u", city);
+}
+
+/**
+ * @brief Mierzy opisy drogi krajowej numer 1
+ * @param map - wskaźnik na mapę
+ * @param cities - liczba miast drogi
+ * @param descriptions - liczba opisów
+ * @param repair - czy przed każdym opisem remontować odcinek drogi
+ * @return false, jeśli nie udało się wyznaczyć opisu; w przeciwnym wypadku
+ * true
+ */
+static bool measureDescriptions(Map *map, unsigned cities,
+                                unsigned descriptions, bool repair)
+{
+    char name[NAME_LENGTH];
+    char next[NAME_LENGTH];
+    unsigned long descriptionAllocations = 0;
+    size_t length = 0;
+    double seconds = 0.0;
+
+    for (unsigned i = 0; i < descriptions; ++i)
+    {
+        if (repair)
+        {
+            unsigned road = i % (cities - 1);
+            cityName(name, road);
+            cityName(next, road + 1);
+            repairRoad(map, name, next, 2000 + (int) i);
+        }
+
+        allocations = 0;
+        clock_t begin = clock();
+        char const *description = getRouteDescription(map, 1);
+        seconds += (double) (clock() - begin) / CLOCKS_PER_SEC;
+        descriptionAllocations += allocations;
+
+        if (description == NULL)
+        {
+            fprintf(stderr, "getRouteDescription failed\n");
+            return false;
+        }
+
+        length = strlen(description);
+        free((void *) description);
+    }
+
+    printf("getRouteDescription, %u cities (%zu characters), %s: %.1f us, "
+           "%.2f allocations per description\n",
+           cities, length, repair ? "after a repair" : "unchanged route",
+           1e6 * seconds / descriptions,
+           (double) descriptionAllocations / descriptions);
+
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    unsigned cities = argc > 1 ? (unsigned) atoi(argv[1]) : DEFAULT_CITIES;
+    unsigned descriptions = argc > 2 ? (unsigned) atoi(argv[2])
+                                     : DEFAULT_DESCRIPTIONS;
+    if (cities < 2 || descriptions == 0)
+    {
+        fprintf(stderr, "Usage: %s [cities >= 2] [descriptions >= 1]\n",
+                argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    Map *map = newMap();
+    if (map == NULL)
+    {
+        fprintf(stderr, "out of memory\n");
+        return EXIT_FAILURE;
+    }
+
+    char name[NAME_LENGTH];
+    cityName(name, 0);
+    if (newCustomRoute(map, 1, name) == NULL)
+    {
+        fprintf(stderr, "newCustomRoute failed\n");
+        return EXIT_FAILURE;
+    }
+
+    // varied lengths and years give numbers of every width
+    for (unsigned i = 1; i < cities; ++i)
+    {
+        cityName(name, i);
+        if (!extendCustomRoute(map, 1, 1 + i % 1000, 1900 + (int) (i % 100),
+                               name))
+        {
+            fprintf(stderr, "extendCustomRoute failed at city %u\n", i);
+            return EXIT_FAILURE;
+        }
+    }
+
+    bool measured = measureDescriptions(map, cities, descriptions, true) &&
+                    measureDescriptions(map, cities, descriptions, false);
+
+    deleteMap(map);
+    return measured ? EXIT_SUCCESS : EXIT_FAILURE;
+}
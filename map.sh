@@ -23,7 +23,7 @@ do
         exit 1
     fi
     #check if it is correct number
-    if [ $ROUTE -gt 1000 ] || [ $ROUTE -le 0 ] 
+    if [ $ROUTE -gt 4294967295 ] || [ $ROUTE -le 0 ] 
     then
         exit 1
     fi
@@ -0,0 +1,112 @@
+/** @file
+ * Implementacja klasy CityPositions
+ *
+ * @author Filip Bieńkowski 407686
+ * @copyright Uniwersytet Warszawski
+ */
+
+#include "CityPositions.h"
+#include "OpenAddressing.h"
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <limits.h>
+
+#define INITIAL_POSITIONS_CAPACITY 16
+
+/**
+ * @brief Sprawdza, czy pozycja tablicy haszującej jest wolna
+ * @param slot - element tablicy
+ * @return wartość @p true jeśli jest wolna, @p false w przeciwnym wypadku
+ */
+static inline bool slotIsEmpty(PositionSlot slot)
+{
+    return slot.city == NULL;
+}
+
+/**
+ * @brief Miasto zajmujące pozycję tablicy haszującej
+ * @param slot - zajęty element tablicy
+ * @return Wskaźnik na miasto
+ */
+static inline struct City *slotCity(PositionSlot slot)
+{
+    return slot.city;
+}
+
+/**
+ * @brief Adres miasta zapisany jako liczba
+ * @param city - wskaźnik na miasto
+ * @return Adres miasta
+ */
+static inline uint64_t cityBits(struct City *city)
+{
+    return (uintptr_t) city;
+}
+
+OPEN_ADDRESSING_TABLE(slots, PositionSlot, struct City *,
+                      slotIsEmpty, slotCity, cityBits)
+
+CityPositions* newCityPositions(struct City **cities, unsigned length)
+{
+    CityPositions *positions = malloc(sizeof(CityPositions));
+
+    if (positions == NULL) return NULL;
+
+    positions->slots = NULL;
+    positions->capacity = 0;
+    positions->count = 0;
+
+    for (unsigned i = 0; i < length; ++i)
+    {
+        if (!addCityPosition(positions, cities[i], i))
+        {
+            removeCityPositions(positions);
+            return NULL;
+        }
+    }
+
+    return positions;
+}
+
+void removeCityPositions(CityPositions *positions)
+{
+    if (positions != NULL)
+    {
+        free(positions->slots);
+        free(positions);
+    }
+}
+
+unsigned findCityPosition(CityPositions *positions, struct City *city)
+{
+    if (positions->count == 0) return UINT_MAX;
+
+    PositionSlot *slot = &positions->slots[slotsFind(positions->slots,
+                                                     positions->capacity,
+                                                     city)];
+    return slot->city == NULL ? UINT_MAX : slot->position;
+}
+
+bool addCityPosition(CityPositions *positions, struct City *city,
+                     unsigned position)
+{
+    if (tableNeedsGrowth(positions->count, positions->capacity) &&
+        !slotsGrow(&positions->slots, &positions->capacity,
+                   INITIAL_POSITIONS_CAPACITY))
+    {
+        return false;
+    }
+
+    PositionSlot *slot = &positions->slots[slotsFind(positions->slots,
+                                                     positions->capacity,
+                                                     city)];
+    if (slot->city == NULL)
+    {
+        slot->city = city;
+        slot->position = position;
+        positions->count++;
+    }
+
+    return true;
+}
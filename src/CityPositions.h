@@ -0,0 +1,88 @@
+/** @file
+ * Interfejs klasy CityPositions - indeksu pozycji miast na drodze krajowej
+ *
+ * @author Filip Bieńkowski 407686
+ * @copyright Uniwersytet Warszawski
+ */
+
+#ifndef DROGI_CITYPOSITIONS_H
+#define DROGI_CITYPOSITIONS_H
+
+#include <stdbool.h>
+
+struct City;
+
+/**
+ * @brief Miasto wraz z jego pozycją na drodze krajowej
+ */
+struct PositionSlot
+{
+    /**
+     * @brief Wskaźnik na miasto, NULL jeśli pozycja tablicy jest wolna
+     */
+    struct City *city;
+
+    /**
+     * @brief Indeks pierwszego wystąpienia miasta na drodze krajowej
+     */
+    unsigned position;
+};
+typedef struct PositionSlot PositionSlot;
+
+/**
+ * @brief Indeks pozycji miast na drodze krajowej. Tablica haszująca
+ * z adresowaniem otwartym i liniowym próbkowaniem, kluczowana adresem miasta.
+ */
+struct CityPositions
+{
+    /**
+     * @brief Tablica haszująca; jej rozmiar jest potęgą dwójki
+     */
+    PositionSlot *slots;
+
+    /**
+     * @brief Rozmiar tablicy slots
+     */
+    unsigned capacity;
+
+    /**
+     * @brief Liczba różnych miast w indeksie
+     */
+    unsigned count;
+};
+typedef struct CityPositions CityPositions;
+
+/**
+ * @brief Stwórz indeks pozycji miast z tablicy kolejnych miast drogi
+ * @param cities - Kolejne miasta drogi krajowej
+ * @param length - Liczba miast
+ * @return Wskaźnik na nowy indeks, lub NULL jeśli nie udało się stworzyć
+ */
+CityPositions* newCityPositions(struct City **cities, unsigned length);
+
+/**
+ * @brief Usuń dany indeks
+ * @param positions - Wskaźnik na usuwany indeks, może być NULL
+ */
+void removeCityPositions(CityPositions *positions);
+
+/**
+ * @brief Znajdź pierwszą pozycję miasta na drodze
+ * @param positions - Wskaźnik na indeks
+ * @param city - Szukane miasto
+ * @return Pozycja miasta, lub UINT_MAX jeśli miasta nie ma w indeksie
+ */
+unsigned findCityPosition(CityPositions *positions, struct City *city);
+
+/**
+ * @brief Dopisz miasto na danej pozycji. Jeśli miasto już jest w indeksie,
+ * zachowywana jest jego wcześniejsza pozycja.
+ * @param positions - Wskaźnik na indeks
+ * @param city - Dopisywane miasto
+ * @param position - Pozycja miasta na drodze
+ * @return wartość @p true jeśli się udało, @p false jeśli zabrakło pamięci
+ */
+bool addCityPosition(CityPositions *positions, struct City *city,
+                     unsigned position);
+
+#endif //DROGI_CITYPOSITIONS_H
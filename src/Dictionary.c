@@ -8,45 +8,183 @@
 
 #include "Dictionary.h"
 
+#define INITIAL_DICTIONARY_CAPACITY 64
+
+/**
+ * @brief Stałe mieszające funkcji hashującej
+ */
+#define HASH_P0 0xA0761D6478BD642FULL
+#define HASH_P1 0xE7037ED1A0B428DBULL
+
+/**
+ * @brief Mnoży dwie liczby 64-bitowe i składa obie połowy 128-bitowego iloczynu
+ * @param a - pierwszy czynnik
+ * @param b - drugi czynnik
+ * @return Xor starszej i młodszej połowy iloczynu
+ */
+static inline uint64_t mix(uint64_t a, uint64_t b)
+{
+#ifdef __SIZEOF_INT128__
+    unsigned __int128 product = (unsigned __int128) a * b;
+    return (uint64_t) product ^ (uint64_t) (product >> 64);
+#else
+    uint64_t aLow = (uint32_t) a, aHigh = a >> 32;
+    uint64_t bLow = (uint32_t) b, bHigh = b >> 32;
+    uint64_t lowLow = aLow * bLow, lowHigh = aLow * bHigh;
+    uint64_t highLow = aHigh * bLow, highHigh = aHigh * bHigh;
+    uint64_t middle = (lowLow >> 32) + (uint32_t) lowHigh + (uint32_t) highLow;
+    uint64_t low = (middle << 32) | (uint32_t) lowLow;
+    uint64_t high = highHigh + (lowHigh >> 32) + (highLow >> 32) +
+                    (middle >> 32);
+    return low ^ high;
+#endif
+}
+
 /**
- * @brief Funkcja pomocnicza do usuwania podlist słownika
- * @param this - Węzeł do usunięcia, ktorego następniki też zostaną usunięte
+ * @brief Czyta 8 bajtów spod dowolnego adresu
+ * @param p - adres
+ * @return Odczytane słowo
  */
-static void removeSubList(struct dNode *this)
+static inline uint64_t read64(const unsigned char *p)
 {
-    if (this != NULL)
+    uint64_t word;
+    memcpy(&word, p, sizeof(word));
+    return word;
+}
+
+/**
+ * @brief Czyta 4 bajty spod dowolnego adresu
+ * @param p - adres
+ * @return Odczytane słowo
+ */
+static inline uint64_t read32(const unsigned char *p)
+{
+    uint32_t word;
+    memcpy(&word, p, sizeof(word));
+    return word;
+}
+
+uint64_t hashKey(Key key)
+{
+    size_t length = strlen(key);
+    const unsigned char *p = (const unsigned char *) key;
+    uint64_t seed = HASH_P0 ^ mix(length ^ HASH_P0, HASH_P1);
+    uint64_t a, b;
+
+    // names sharing a long prefix still differ in the last words, which are
+    // mixed in a multiply each, unlike the old byte-at-a-time hash
+    size_t left = length;
+    for (; left > 16; left -= 16, p += 16)
     {
-        removeSubList(this->next);
-        free(this);
+        seed = mix(read64(p) ^ HASH_P1, read64(p + 8) ^ seed);
     }
+
+    if (left >= 8)
+    {
+        // the two words may overlap, which is cheaper than a byte loop
+        a = read64(p);
+        b = read64(p + left - 8);
+    }
+    else if (left >= 4)
+    {
+        a = read32(p);
+        b = read32(p + left - 4);
+    }
+    else if (left > 0)
+    {
+        a = ((uint64_t) p[0] << 16) | ((uint64_t) p[left / 2] << 8) |
+            p[left - 1];
+        b = 0;
+    }
+    else
+    {
+        a = b = 0;
+    }
+
+    return mix(HASH_P1 ^ length, mix(a ^ HASH_P1, b ^ seed));
+}
+
+/**
+ * @brief Pozycja domowa elementu o danym hashu
+ * @param dictionary - wskaźnik na słownik
+ * @param hash - hash klucza
+ * @return Pozycja, od której zaczyna się szukanie klucza
+ */
+static inline unsigned homeOf(Dictionary *dictionary, uint64_t hash)
+{
+    return (unsigned) (hash >> 32) & (dictionary->capacity - 1);
+}
+
+/**
+ * @brief Odległość pozycji od pozycji domowej elementu o danym hashu
+ * @param dictionary - wskaźnik na słownik
+ * @param hash - hash klucza
+ * @param position - pozycja w tablicy
+ * @return Liczba kroków próbkowania od pozycji domowej
+ */
+static inline unsigned probeDistance(Dictionary *dictionary, uint64_t hash,
+                                     unsigned position)
+{
+    return (position - homeOf(dictionary, hash)) & (dictionary->capacity - 1);
 }
 
 /**
- * @brief Funkcja znajduje hashvalue dla zadanego klucza będącego stringiem
- * @param key - string będący kluczem
- * @return Hashvalue dla zadanego stringa
+ * @brief Umieszcza element w tablicy z wolnym miejscem
+ * @param dictionary - wskaźnik na słownik
+ * @param entry - umieszczany element
  */
-static inline unsigned hashFor(Key key)
+static void placeEntry(Dictionary *dictionary, dEntry entry)
 {
-    unsigned hash = 0;
+    unsigned mask = dictionary->capacity - 1;
+    unsigned position = homeOf(dictionary, entry.hash);
+    unsigned distance = 0;
 
-    for (; *key != '\0'; key++)
+    while (dictionary->entries[position].this != NULL)
     {
-        hash = *key + 31 * hash;
+        unsigned otherDistance = probeDistance(dictionary,
+                                               dictionary->entries[position].hash,
+                                               position);
+        if (otherDistance < distance)
+        {
+            // the resident is closer to home, so it moves on instead
+            dEntry swapped = dictionary->entries[position];
+            dictionary->entries[position] = entry;
+            entry = swapped;
+            distance = otherDistance;
+        }
+
+        position = (position + 1) & mask;
+        distance++;
     }
 
-    return hash % HASHSIZE;
+    dictionary->entries[position] = entry;
 }
 
 /**
- * @brief Inicjalizuje pola w nowo utworzonym węźle
- * @param newNode - wskaźnik na nowy węzeł
- * @param value - wartość w węźle
+ * @brief Powiększa dwukrotnie tablicę i rozmieszcza elementy od nowa
+ * @param dictionary - wskaźnik na słownik
+ * @return wartość @p true jeśli się udało, @p false jeśli zabrakło pamięci
  */
-static inline void setFields(dNode *newNode, Value value)
+static bool grow(Dictionary *dictionary)
 {
-    newNode->next = NULL;
-    newNode->this = value;
+    unsigned oldCapacity = dictionary->capacity;
+    dEntry *oldEntries = dictionary->entries;
+    unsigned newCapacity = oldCapacity == 0
+                           ? INITIAL_DICTIONARY_CAPACITY : 2 * oldCapacity;
+
+    dEntry *newEntries = calloc(newCapacity, sizeof(dEntry));
+    if (newEntries == NULL) return false;
+
+    dictionary->entries = newEntries;
+    dictionary->capacity = newCapacity;
+
+    for (unsigned i = 0; i < oldCapacity; ++i)
+    {
+        if (oldEntries[i].this != NULL) placeEntry(dictionary, oldEntries[i]);
+    }
+
+    free(oldEntries);
+    return true;
 }
 
 Dictionary* newDictionary()
@@ -54,40 +192,49 @@ Dictionary* newDictionary()
     Dictionary *dictionary = malloc(sizeof(Dictionary));
     
     if (dictionary == NULL) return NULL;
-    
-    for (int i = 0; i < HASHSIZE; ++i)
-    {
-        dictionary->nodes[i] = NULL;
-    }
+
+    dictionary->entries = NULL;
+    dictionary->size = 0;
+    dictionary->capacity = 0;
 
     return dictionary;
 }
 
 void removeDictionary(Dictionary *dictionary)
 {
-    for (int i = 0; i < HASHSIZE; ++i)
-    {
-        // Remove all nodes in given sublist
-        removeSubList(dictionary->nodes[i]);
-    }
-
+    free(dictionary->entries);
     free(dictionary);
 }
 
 Value get(Dictionary *dictionary, Key key)
 {
-    dNode *current = dictionary->nodes[hashFor(key)];
+    return getHashed(dictionary, key, hashKey(key));
+}
+
+Value getHashed(Dictionary *dictionary, Key key, uint64_t hash)
+{
+    if (dictionary->size == 0) return NULL;
 
-    while (current != NULL)
+    unsigned mask = dictionary->capacity - 1;
+    unsigned position = homeOf(dictionary, hash);
+
+    for (unsigned distance = 0; ; ++distance)
     {
-        if (strcmp(current->this->name, key) == 0)
+        dEntry *current = &dictionary->entries[position];
+
+        // a key placed further on would have displaced this element
+        if (current->this == NULL ||
+            probeDistance(dictionary, current->hash, position) < distance)
         {
-            return current->this;
+            break;
         }
-        else
+
+        if (current->hash == hash && strcmp(current->this->name, key) == 0)
         {
-            current = current->next;
+            return current->this;
         }
+
+        position = (position + 1) & mask;
     }
 
     // Nothing found for this key
@@ -96,35 +243,23 @@ Value get(Dictionary *dictionary, Key key)
 
 bool put(Dictionary *dictionary, Value value)
 {
-    Key key = value->name;
-    unsigned hashValue = hashFor(key);
+    return putHashed(dictionary, value, hashKey(value->name));
+}
 
-    if (dictionary->nodes[hashValue] == NULL)
+bool putHashed(Dictionary *dictionary, Value value, uint64_t hash)
+{
+    // keep the load factor at most 3/4
+    if (4 * (dictionary->size + 1) > 3 * dictionary->capacity &&
+        !grow(dictionary))
     {
-        // First element
-        dictionary->nodes[hashValue] = malloc(sizeof(dNode));
-        // Not enough memory
-        if (dictionary->nodes[hashValue] == NULL) return false;
-        // Set fields
-        setFields(dictionary->nodes[hashValue], value);
-    }
-    else
-    {
-        // At least second element
-        dNode *current = dictionary->nodes[hashValue];
-        // Go to the end of the list
-        while (current->next != NULL)
-        {
-            current = current->next;
-        }
-        // Current->next == NULL
-        current->next = malloc(sizeof(dNode));
-        // Memory fail
-        if (current->next == NULL) return false;
-        // Set fields
-        setFields(current->next, value);
+        return false;
     }
 
+    dEntry entry;
+    entry.hash = hash;
+    entry.this = value;
+
+    placeEntry(dictionary, entry);
+    dictionary->size++;
     return true;
 }
-
@@ -10,11 +10,10 @@
 
 #include "map.h"
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 
-#define HASHSIZE 1009
-
 /**
  * @brief Typ przechowywany w słowniku. Domyślnie wskaźnik na City.
  */
@@ -26,24 +25,56 @@ typedef struct City* Value;
 typedef const char* Key;
 
 /**
- * @brief Węzeł wewnętrzny słownika
+ * @brief Pozycja tablicy słownika
  */
-struct dNode
+struct dEntry
 {
-    struct dNode *next;
+    /**
+     * @brief Pełny 64-bitowy hash klucza; porównujemy napisy tylko wtedy,
+     * gdy hashe są równe
+     */
+    uint64_t hash;
+
+    /**
+     * @brief Przechowywany element, lub NULL jeśli pozycja jest wolna
+     */
     Value this;
 };
-typedef struct dNode dNode;
+typedef struct dEntry dEntry;
 
 /**
- * @brief Główna struktura
+ * @brief Główna struktura. Tablica z adresowaniem otwartym i liniowym
+ * próbkowaniem w wariancie Robin Hood: element dalej od swojej pozycji
+ * domowej wypiera przy wstawianiu element bliżej swojej, więc poszukiwanie
+ * nieobecnego klucza kończy się, gdy tylko trafi na element bliższy domu.
  */
 struct Dictionary
 {
-    struct dNode *nodes[HASHSIZE];
+    /**
+     * @brief Tablica pozycji; jej rozmiar jest potęgą dwójki
+     */
+    dEntry *entries;
+
+    /**
+     * @brief Liczba elementów w słowniku
+     */
+    unsigned size;
+
+    /**
+     * @brief Rozmiar tablicy pozycji
+     */
+    unsigned capacity;
 };
 typedef struct Dictionary Dictionary;
 
+/**
+ * @brief Oblicz hash klucza. Wynik można przekazać do getHashed i putHashed,
+ * aby nie liczyć go ponownie przy kolejnych operacjach na tym samym kluczu.
+ * @param key - Klucz
+ * @return 64-bitowy hash klucza
+ */
+uint64_t hashKey(Key key);
+
 /**
  * @brief Stwórz nowy słownik
  * @return Wskaźnik na nowy słownik, lub NULL jeśli nie udało się stworzyć
@@ -64,6 +95,15 @@ void removeDictionary(Dictionary *dictionary);
  */
 Value get(Dictionary *dictionary, Key key);
 
+/**
+ * @brief Uzyskaj element dopasowany do danego klucza o znanym hashu
+ * @param dictionary - Wskaźnik na zadany słownik
+ * @param key - Klucz zadanego elementu
+ * @param hash - Wynik hashKey(key)
+ * @return Element jeśli jest, NULL jeśli nie ma takiego elementu
+ */
+Value getHashed(Dictionary *dictionary, Key key, uint64_t hash);
+
 /**
  * @brief Włóż dany element do słownika.
  * @param dictionary - Wskaźnik na słownik
@@ -72,4 +112,13 @@ Value get(Dictionary *dictionary, Key key);
  */
 bool put(Dictionary *dictionary, Value value);
 
+/**
+ * @brief Włóż dany element o znanym hashu klucza do słownika.
+ * @param dictionary - Wskaźnik na słownik
+ * @param value - Element wkładany. Jego pole "name" pełni rolę klucza
+ * @param hash - Wynik hashKey(value->name)
+ * @return wartość @p true jeśli udało się włożyć, @p false jeśli nie.
+ */
+bool putHashed(Dictionary *dictionary, Value value, uint64_t hash);
+
 #endif //DROGI_DICTIONARY_H
@@ -0,0 +1,391 @@
+/** @file
+ * Implementacja klasy InputReader
+ *
+ * @author Filip Bieńkowski 407686
+ * @copyright Uniwersytet Warszawski
+ */
+
+#include "InputReader.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <ctype.h>
+#include <limits.h>
+
+#if defined(__SSE2__) && defined(__GNUC__) && !defined(SCALAR_SCANNER)
+#define SSE2_SCANNER
+#include <emmintrin.h>
+#endif
+
+#define INPUT_CHUNK (1u << 20)
+#define INITIAL_SEPARATORS_CAPACITY 64
+#define SCAN_BLOCK 16
+
+InputReader* newInputReader(int descriptor)
+{
+    InputReader *reader = malloc(sizeof(InputReader));
+
+    if (reader == NULL) return NULL;
+
+    // the extra character terminates a line that ends the buffer
+    reader->buffer = malloc(sizeof(char) * (INPUT_CHUNK + 1));
+    if (reader->buffer == NULL)
+    {
+        free(reader);
+        return NULL;
+    }
+
+    reader->descriptor = descriptor;
+    reader->capacity = INPUT_CHUNK;
+    reader->begin = 0;
+    reader->end = 0;
+    reader->savedChar = '\0';
+    reader->finished = false;
+    reader->line = NULL;
+    reader->lineLength = 0;
+    reader->separators = NULL;
+    reader->separatorsCount = 0;
+    reader->separatorsCapacity = 0;
+    reader->nextField = 0;
+    reader->beforeRead = NULL;
+    reader->beforeReadData = NULL;
+
+    return reader;
+}
+
+void removeInputReader(InputReader *reader)
+{
+    if (reader != NULL)
+    {
+        free(reader->buffer);
+        free(reader->separators);
+        free(reader);
+    }
+}
+
+void setBeforeRead(InputReader *reader, void (*callback)(void *data),
+                   void *data)
+{
+    reader->beforeRead = callback;
+    reader->beforeReadData = data;
+}
+
+/**
+ * @brief Dopisuje do bufora kolejną porcję wejścia, przesuwając wcześniej
+ * nieprzetworzone dane na jego początek i w razie potrzeby go powiększając
+ * @param reader - wskaźnik na czytnik
+ * @return false, jeśli wejście się skończyło lub zabrakło pamięci;
+ * w przeciwnym wypadku true
+ */
+static bool fillBuffer(InputReader *reader)
+{
+    if (reader->begin > 0)
+    {
+        memmove(reader->buffer, reader->buffer + reader->begin,
+                reader->end - reader->begin);
+        reader->end -= reader->begin;
+        reader->begin = 0;
+    }
+
+    // the whole buffer is one unfinished line
+    if (reader->end == reader->capacity)
+    {
+        size_t newCapacity = 2 * reader->capacity;
+        char *newBuffer = realloc(reader->buffer,
+                                  sizeof(char) * (newCapacity + 1));
+        if (newBuffer == NULL) return false;
+
+        reader->buffer = newBuffer;
+        reader->capacity = newCapacity;
+    }
+
+    if (reader->beforeRead != NULL) reader->beforeRead(reader->beforeReadData);
+
+    ssize_t count;
+    do
+    {
+        count = read(reader->descriptor, reader->buffer + reader->end,
+                     reader->capacity - reader->end);
+    } while (count < 0 && errno == EINTR);
+
+    if (count <= 0) return false;
+
+    reader->end += count;
+    return true;
+}
+
+/**
+ * @brief Zapewnia miejsce na podaną liczbę kolejnych separatorów
+ * @param reader - wskaźnik na czytnik
+ * @param count - liczba separatorów, które mogą zostać dopisane
+ * @return false, jeśli zabrakło pamięci; w przeciwnym wypadku true
+ */
+static bool reserveSeparators(InputReader *reader, size_t count)
+{
+    if (reader->separatorsCount + count <= reader->separatorsCapacity)
+    {
+        return true;
+    }
+
+    size_t newCapacity = reader->separatorsCapacity == 0
+                         ? INITIAL_SEPARATORS_CAPACITY
+                         : 2 * reader->separatorsCapacity;
+    while (newCapacity < reader->separatorsCount + count) newCapacity *= 2;
+
+    size_t *newSeparators = realloc(reader->separators,
+                                    sizeof(size_t) * newCapacity);
+    if (newSeparators == NULL) return false;
+
+    reader->separators = newSeparators;
+    reader->separatorsCapacity = newCapacity;
+    return true;
+}
+
+/**
+ * @brief Wynik przeszukiwania wczytanej części wiersza
+ */
+enum ScanResult
+{
+    /**
+     * @brief Znaleziono koniec wiersza
+     */
+    SCAN_LINE_END,
+
+    /**
+     * @brief Wczytana część wiersza nie zawiera końca linii
+     */
+    SCAN_MORE_NEEDED,
+
+    /**
+     * @brief Zabrakło pamięci na pozycje separatorów
+     */
+    SCAN_NO_MEMORY
+};
+
+/**
+ * @brief Przeszukuje wczytaną część bieżącego wiersza, zapisując pozycje
+ * separatorów i sprawdzając, czy wiersz zawiera znak '\0'
+ * @param reader - wskaźnik na czytnik; wiersz zaczyna się na pozycji begin
+ * @param scanned - liczba przeszukanych już znaków wiersza; po znalezieniu
+ * końca wiersza jest to pozycja znaku końca linii
+ * @param hasNull - ustawiane na true, jeśli wiersz zawiera znak '\0'
+ * @return Wynik przeszukiwania
+ */
+static enum ScanResult scanLine(InputReader *reader, size_t *scanned,
+                                bool *hasNull)
+{
+    const char *line = reader->buffer + reader->begin;
+    size_t available = reader->end - reader->begin;
+    size_t i = *scanned;
+
+#ifdef SSE2_SCANNER
+    const __m128i semicolons = _mm_set1_epi8(';');
+    const __m128i newLines = _mm_set1_epi8('\n');
+    const __m128i nulls = _mm_setzero_si128();
+
+    // each block gives bit masks of the three interesting characters
+    for (; i + SCAN_BLOCK <= available; i += SCAN_BLOCK)
+    {
+        __m128i block = _mm_loadu_si128((const __m128i *) (line + i));
+        unsigned separatorBits =
+                (unsigned) _mm_movemask_epi8(_mm_cmpeq_epi8(block, semicolons));
+        unsigned newLineBits =
+                (unsigned) _mm_movemask_epi8(_mm_cmpeq_epi8(block, newLines));
+        unsigned nullBits =
+                (unsigned) _mm_movemask_epi8(_mm_cmpeq_epi8(block, nulls));
+
+        // only characters before the first new line belong to this line
+        unsigned lineBits = newLineBits == 0
+                            ? 0xFFFFu : (newLineBits & -newLineBits) - 1;
+        separatorBits &= lineBits;
+        if ((nullBits & lineBits) != 0) *hasNull = true;
+
+        if (!reserveSeparators(reader, SCAN_BLOCK)) return SCAN_NO_MEMORY;
+        for (; separatorBits != 0; separatorBits &= separatorBits - 1)
+        {
+            reader->separators[reader->separatorsCount++] =
+                    i + __builtin_ctz(separatorBits);
+        }
+
+        if (newLineBits != 0)
+        {
+            *scanned = i + __builtin_ctz(newLineBits);
+            return SCAN_LINE_END;
+        }
+    }
+#endif
+
+    // what is left is shorter than a block, or there are no blocks at all;
+    // the library routines still look at whole words at a time
+    const char *newLine = memchr(line + i, '\n', available - i);
+    size_t stop = newLine == NULL ? available : (size_t) (newLine - line);
+
+    if (memchr(line + i, '\0', stop - i) != NULL) *hasNull = true;
+
+    const char *separator;
+    while ((separator = memchr(line + i, ';', stop - i)) != NULL)
+    {
+        if (!reserveSeparators(reader, 1)) return SCAN_NO_MEMORY;
+        i = separator - line;
+        reader->separators[reader->separatorsCount++] = i;
+        ++i;
+    }
+
+    if (newLine != NULL)
+    {
+        *scanned = stop;
+        return SCAN_LINE_END;
+    }
+
+    *scanned = stop;
+    return SCAN_MORE_NEEDED;
+}
+
+LineStatus readLine(InputReader *reader)
+{
+    // the character after the previous line belongs to the data again
+    if (reader->line != NULL)
+    {
+        reader->buffer[reader->begin] = reader->savedChar;
+        reader->line = NULL;
+    }
+
+    if (reader->finished) return LINE_NONE;
+
+    // positions are kept relative to the line, so moving data keeps them valid
+    size_t scanned = 0;
+    bool hasNull = false;
+    reader->separatorsCount = 0;
+
+    enum ScanResult result;
+    while ((result = scanLine(reader, &scanned, &hasNull)) != SCAN_LINE_END)
+    {
+        if (result == SCAN_NO_MEMORY || !fillBuffer(reader))
+        {
+            reader->finished = true;
+            // data left without a new line can not form a whole line
+            return result != SCAN_NO_MEMORY && reader->begin < reader->end
+                   ? LINE_MALFORMED : LINE_NONE;
+        }
+    }
+
+    reader->line = reader->buffer + reader->begin;
+    reader->lineLength = scanned + 1;
+    reader->nextField = 0;
+    reader->begin += reader->lineLength;
+
+    reader->savedChar = reader->buffer[reader->begin];
+    reader->buffer[reader->begin] = '\0';
+
+    // a line read as a string would end early, so it would have no new line
+    if (hasNull)
+    {
+        reader->finished = true;
+        return LINE_MALFORMED;
+    }
+
+    return LINE_READ;
+}
+
+bool nextToken(InputReader *reader, Token *token)
+{
+    // empty fields are skipped, just like strtok does
+    while (reader->nextField <= reader->separatorsCount)
+    {
+        size_t field = reader->nextField++;
+        size_t start = field == 0 ? 0 : reader->separators[field - 1] + 1;
+
+        if (field == reader->separatorsCount)
+        {
+            // the last token keeps the new line, which is followed by '\0'
+            token->text = reader->line + start;
+            token->length = reader->lineLength - start;
+            return true;
+        }
+
+        size_t end = reader->separators[field];
+        if (end > start)
+        {
+            reader->line[end] = '\0';
+            token->text = reader->line + start;
+            token->length = end - start;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Odczytuje liczbę dziesiętną z podanego wyrazu
+ * Funkcja przyjmuje te same zapisy co strtol o podstawie 10, za którym musi
+ * stać znak '\0': białe znaki na początku, opcjonalny znak '+' lub '-' i same
+ * cyfry do końca wyrazu, a pusty wyraz oznacza 0. Odczytywane są tylko
+ * znaki wyrazu, więc nie trzeba szukać jego końca. Liczba spoza podanego
+ * zakresu jest odrzucana, gdy tylko go przekroczy.
+ * @param token - Wyraz do odczytania
+ * @param lowest - Najmniejsza dopuszczalna wartość, nie większa niż 0
+ * @param highest - Największa dopuszczalna wartość
+ * @param numerical - Tu zapisywana jest odczytana wartość
+ * @return wartość @p true, jeśli się udało, wartość @p false jeśli wystąpił błąd:
+ * wartość za duża, za mała, lub nieoczekiwane znaki.
+ */
+static bool parseDecimal(const Token *token, long long lowest,
+                         long long highest, long long *numerical)
+{
+    const char *act = token->text;
+    const char *end = token->text + token->length;
+
+    // strtol reads nothing from an empty string, but it leaves nothing behind
+    if (act == end)
+    {
+        *numerical = 0;
+        return true;
+    }
+
+    while (act < end && isspace((unsigned char) *act)) ++act;
+
+    bool negative = false;
+    if (act < end && (*act == '+' || *act == '-'))
+    {
+        negative = *act == '-';
+        ++act;
+    }
+
+    // without any digit strtol stops at the beginning of the string
+    if (act == end) return false;
+
+    unsigned long long limit = negative ? (unsigned long long) -lowest
+                                        : (unsigned long long) highest;
+    unsigned long long magnitude = 0;
+    for (; act < end; ++act)
+    {
+        if (*act < '0' || *act > '9') return false;
+
+        magnitude = 10 * magnitude + (*act - '0');
+        if (magnitude > limit) return false;
+    }
+
+    *numerical = negative ? -(long long) magnitude : (long long) magnitude;
+    return true;
+}
+
+bool tokenToInt(const Token *token, int *numerical)
+{
+    long long value;
+    if (!parseDecimal(token, INT_MIN, INT_MAX, &value)) return false;
+
+    *numerical = value;
+    return true;
+}
+
+bool tokenToUnsigned(const Token *token, unsigned *numerical)
+{
+    long long value;
+    if (!parseDecimal(token, 0, UINT_MAX, &value)) return false;
+
+    *numerical = value;
+    return true;
+}
@@ -0,0 +1,205 @@
+/** @file
+ * Interfejs klasy InputReader - czytnika poleceń dzielącego wejście na wiersze
+ * i wyrazy bez kopiowania
+ *
+ * @author Filip Bieńkowski 407686
+ * @copyright Uniwersytet Warszawski
+ */
+
+#ifndef DROGI_INPUTREADER_H
+#define DROGI_INPUTREADER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @brief Wyraz polecenia, wskazujący bezpośrednio na bufor czytnika.
+ * Tekst jest zakończony znakiem '\0', więc można go używać jak zwykłego napisu.
+ */
+struct Token
+{
+    /**
+     * @brief Początek wyrazu
+     */
+    char *text;
+
+    /**
+     * @brief Długość wyrazu, bez kończącego znaku '\0'
+     */
+    size_t length;
+};
+typedef struct Token Token;
+
+/**
+ * @brief Wynik wczytywania wiersza
+ */
+enum LineStatus
+{
+    /**
+     * @brief Wczytano cały wiersz, zakończony znakiem końca linii
+     */
+    LINE_READ,
+
+    /**
+     * @brief Wiersz nie kończy się znakiem końca linii albo zawiera znak '\0';
+     * dalsza część wejścia nie jest czytana
+     */
+    LINE_MALFORMED,
+
+    /**
+     * @brief Wejście się skończyło albo zabrakło pamięci
+     */
+    LINE_NONE
+};
+typedef enum LineStatus LineStatus;
+
+/**
+ * @brief Czytnik poleceń. Wczytuje wejście dużymi porcjami do jednego bufora,
+ * a wiersze i ich wyrazy udostępnia jako fragmenty tego bufora. Koniec wiersza
+ * i wszystkie separatory ';' są znajdowane jednym przejściem po wierszu.
+ */
+struct InputReader
+{
+    /**
+     * @brief Deskryptor czytanego pliku
+     */
+    int descriptor;
+
+    /**
+     * @brief Bufor na wczytane dane, o jeden znak dłuższy niż capacity
+     */
+    char *buffer;
+
+    /**
+     * @brief Rozmiar bufora
+     */
+    size_t capacity;
+
+    /**
+     * @brief Początek nieprzetworzonych danych w buforze
+     */
+    size_t begin;
+
+    /**
+     * @brief Koniec wczytanych danych w buforze
+     */
+    size_t end;
+
+    /**
+     * @brief Znak nadpisany przez '\0' za bieżącym wierszem
+     */
+    char savedChar;
+
+    /**
+     * @brief Informacja, czy wejście się skończyło
+     */
+    bool finished;
+
+    /**
+     * @brief Bieżący wiersz, ze znakiem końca linii
+     */
+    char *line;
+
+    /**
+     * @brief Długość bieżącego wiersza, ze znakiem końca linii
+     */
+    size_t lineLength;
+
+    /**
+     * @brief Pozycje separatorów ';' bieżącego wiersza, licząc od jego początku
+     */
+    size_t *separators;
+
+    /**
+     * @brief Liczba separatorów bieżącego wiersza
+     */
+    size_t separatorsCount;
+
+    /**
+     * @brief Rozmiar zaalokowanej tablicy separators
+     */
+    size_t separatorsCapacity;
+
+    /**
+     * @brief Numer pola, od którego nextToken() szuka kolejnego wyrazu; pole
+     * i-te kończy się na i-tym separatorze, a ostatnie na końcu wiersza
+     */
+    size_t nextField;
+
+    /**
+     * @brief Funkcja wywoływana przed każdym czytaniem z pliku, które może
+     * czekać na dane, lub NULL
+     */
+    void (*beforeRead)(void *data);
+
+    /**
+     * @brief Argument przekazywany funkcji beforeRead
+     */
+    void *beforeReadData;
+};
+typedef struct InputReader InputReader;
+
+/**
+ * @brief Stwórz czytnik danego pliku
+ * @param descriptor - Deskryptor czytanego pliku
+ * @return Wskaźnik na nowy czytnik, lub NULL jeśli nie udało się stworzyć
+ */
+InputReader* newInputReader(int descriptor);
+
+/**
+ * @brief Usuń dany czytnik. Nie zamyka czytanego pliku.
+ * @param reader - Wskaźnik na usuwany czytnik
+ */
+void removeInputReader(InputReader *reader);
+
+/**
+ * @brief Ustaw funkcję wywoływaną przed każdym czytaniem z pliku. Pozwala
+ * np. wypisać odpowiedzi na polecenia, zanim czytnik zacznie czekać na kolejne.
+ * @param reader - Wskaźnik na czytnik
+ * @param callback - Wywoływana funkcja, lub NULL
+ * @param data - Argument przekazywany funkcji
+ */
+void setBeforeRead(InputReader *reader, void (*callback)(void *data),
+                   void *data);
+
+/**
+ * @brief Wczytaj kolejny wiersz. Wiersz, wraz ze znakiem końca linii, jest
+ * zakończony znakiem '\0' i pozostaje ważny do następnego wywołania.
+ * @param reader - Wskaźnik na czytnik
+ * @return Stan wczytanego wiersza
+ */
+LineStatus readLine(InputReader *reader);
+
+/**
+ * @brief Znajdź kolejny wyraz bieżącego wiersza. Działa jak strtok z
+ * separatorem ";": pomija puste wyrazy, zastępuje separator za wyrazem znakiem
+ * '\0', a ostatni wyraz zawiera znak końca linii.
+ * @param reader - Wskaźnik na czytnik
+ * @param token - Tu zapisywany jest znaleziony wyraz
+ * @return wartość @p true jeśli znaleziono wyraz, @p false jeśli ich zabrakło
+ */
+bool nextToken(InputReader *reader, Token *token);
+
+/**
+ * @brief Odczytaj z wyrazu liczbę typu int. Przyjmowane są te same zapisy co
+ * przez strtol o podstawie 10, za którym musi stać koniec wyrazu: białe znaki
+ * na początku, opcjonalny znak '+' lub '-' i same cyfry, a pusty wyraz
+ * oznacza 0.
+ * @param token - Wyraz do odczytania
+ * @param numerical - Tu zapisywana jest odczytana wartość
+ * @return wartość @p true, jeśli się udało, wartość @p false jeśli wartość
+ * jest spoza zakresu typu int lub wyraz zawiera nieoczekiwane znaki
+ */
+bool tokenToInt(const Token *token, int *numerical);
+
+/**
+ * @brief Odczytaj z wyrazu liczbę typu unsigned, tak jak tokenToInt. Liczba
+ * ujemna jest odrzucana, z wyjątkiem zapisu "-0".
+ * @param token - Wyraz do odczytania
+ * @param numerical - Tu zapisywana jest odczytana wartość
+ * @return wartość @p true, jeśli się udało, wartość @p false jeśli wartość
+ * jest spoza zakresu typu unsigned lub wyraz zawiera nieoczekiwane znaki
+ */
+bool tokenToUnsigned(const Token *token, unsigned *numerical);
+
+#endif //DROGI_INPUTREADER_H
@@ -0,0 +1,100 @@
+/** @file
+ * Implementacja klasy ObjectPool
+ *
+ * @author Filip Bieńkowski 407686
+ * @copyright Uniwersytet Warszawski
+ */
+
+#include "ObjectPool.h"
+
+#include <stdlib.h>
+
+#define INITIAL_BLOCK_OBJECTS 64
+#define MAX_BLOCK_OBJECTS 65536
+
+ObjectPool* newObjectPool(size_t objectSize)
+{
+    ObjectPool *pool = malloc(sizeof(ObjectPool));
+
+    if (pool == NULL) return NULL;
+
+    // a freed object must hold the free list link; struct sizes are already
+    // multiples of their alignment, so consecutive objects stay aligned
+    pool->objectSize = objectSize < sizeof(void *) ? sizeof(void *)
+                                                   : objectSize;
+    pool->freeList = NULL;
+    pool->blocks = NULL;
+    pool->blockUsed = 0;
+    pool->blockCapacity = 0;
+
+    return pool;
+}
+
+void removeObjectPool(ObjectPool *pool)
+{
+    if (pool == NULL) return;
+
+    while (pool->blocks != NULL)
+    {
+        PoolBlock *next = pool->blocks->next;
+        free(pool->blocks);
+        pool->blocks = next;
+    }
+
+    free(pool);
+}
+
+#ifdef OBJECT_POOL_MALLOC
+
+void *poolAlloc(ObjectPool *pool)
+{
+    return malloc(pool->objectSize);
+}
+
+void poolFree(ObjectPool *pool, void *object)
+{
+    (void) pool;
+    free(object);
+}
+
+#else
+
+void *poolAlloc(ObjectPool *pool)
+{
+    if (pool->freeList != NULL)
+    {
+        void *object = pool->freeList;
+        pool->freeList = *(void **) object;
+        return object;
+    }
+
+    if (pool->blockUsed == pool->blockCapacity)
+    {
+        // blocks grow geometrically, so there are few of them even for
+        // millions of objects, and small maps do not reserve much
+        size_t capacity = pool->blockCapacity == 0 ? INITIAL_BLOCK_OBJECTS
+                                                   : 2 * pool->blockCapacity;
+        if (capacity > MAX_BLOCK_OBJECTS) capacity = MAX_BLOCK_OBJECTS;
+
+        PoolBlock *block = malloc(sizeof(PoolBlock) +
+                                  capacity * pool->objectSize);
+        if (block == NULL) return NULL;
+
+        block->next = pool->blocks;
+        pool->blocks = block;
+        pool->blockUsed = 0;
+        pool->blockCapacity = capacity;
+    }
+
+    return pool->blocks->data + pool->objectSize * pool->blockUsed++;
+}
+
+void poolFree(ObjectPool *pool, void *object)
+{
+    if (object == NULL) return;
+
+    *(void **) object = pool->freeList;
+    pool->freeList = object;
+}
+
+#endif
@@ -0,0 +1,104 @@
+/** @file
+ * Interfejs klasy ObjectPool - puli obiektów o stałym rozmiarze
+ *
+ * @author Filip Bieńkowski 407686
+ * @copyright Uniwersytet Warszawski
+ */
+
+#ifndef DROGI_OBJECTPOOL_H
+#define DROGI_OBJECTPOOL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @brief Czy usunięcie puli zwalnia też wszystkie przydzielone z niej obiekty.
+ * Przy kompilacji z OBJECT_POOL_MALLOC pula tylko przekazuje wywołania do
+ * malloc i free, więc obiekty trzeba zwalniać pojedynczo.
+ */
+#ifdef OBJECT_POOL_MALLOC
+#define POOL_RELEASES_OBJECTS false
+#else
+#define POOL_RELEASES_OBJECTS true
+#endif
+
+/**
+ * @brief Blok pamięci puli, mieszczący wiele obiektów
+ */
+struct PoolBlock
+{
+    /**
+     * @brief Poprzednio zaalokowany blok
+     */
+    struct PoolBlock *next;
+
+    /**
+     * @brief Obiekty bloku
+     */
+    _Alignas(max_align_t) unsigned char data[];
+};
+typedef struct PoolBlock PoolBlock;
+
+/**
+ * @brief Pula obiektów o stałym rozmiarze. Obiekty są wydawane kolejno
+ * z coraz większych bloków, a zwolnione trafiają na listę wolnych obiektów
+ * i są wydawane ponownie w pierwszej kolejności.
+ */
+struct ObjectPool
+{
+    /**
+     * @brief Rozmiar obiektu w bajtach
+     */
+    size_t objectSize;
+
+    /**
+     * @brief Lista zwolnionych obiektów, połączonych przez ich pierwsze bajty
+     */
+    void *freeList;
+
+    /**
+     * @brief Lista bloków, od najnowszego
+     */
+    PoolBlock *blocks;
+
+    /**
+     * @brief Liczba obiektów wydanych z najnowszego bloku
+     */
+    size_t blockUsed;
+
+    /**
+     * @brief Liczba obiektów mieszczących się w najnowszym bloku
+     */
+    size_t blockCapacity;
+};
+typedef struct ObjectPool ObjectPool;
+
+/**
+ * @brief Stwórz nową pulę
+ * @param objectSize - Rozmiar wydawanych obiektów w bajtach
+ * @return Wskaźnik na nową pulę, lub NULL jeśli nie udało się stworzyć
+ */
+ObjectPool* newObjectPool(size_t objectSize);
+
+/**
+ * @brief Usuń pulę wraz ze wszystkimi blokami. Jeśli POOL_RELEASES_OBJECTS
+ * jest prawdą, zwalnia to również wszystkie niezwolnione obiekty.
+ * @param pool - Wskaźnik na usuwaną pulę
+ */
+void removeObjectPool(ObjectPool *pool);
+
+/**
+ * @brief Przydziel obiekt z puli
+ * @param pool - Wskaźnik na pulę
+ * @return Wskaźnik na niezainicjowany obiekt, lub NULL jeśli zabrakło pamięci
+ */
+void *poolAlloc(ObjectPool *pool);
+
+/**
+ * @brief Oddaj obiekt do puli
+ * @param pool - Wskaźnik na pulę, z której obiekt przydzielono
+ * @param object - Zwalniany obiekt, lub NULL
+ */
+void poolFree(ObjectPool *pool, void *object);
+
+#endif //DROGI_OBJECTPOOL_H
@@ -0,0 +1,138 @@
+/** @file
+ * Wspólna implementacja tablic haszujących z adresowaniem otwartym
+ * i liniowym próbkowaniem, konkretyzowana dla każdego typu klucza
+ *
+ * @author Filip Bieńkowski 407686
+ * @copyright Uniwersytet Warszawski
+ */
+
+#ifndef DROGI_OPENADDRESSING_H
+#define DROGI_OPENADDRESSING_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/**
+ * @brief Pozycja, od której zaczynamy szukać klucza
+ * @param bits - klucz zapisany jako liczba
+ * @param capacity - rozmiar tablicy, potęga dwójki
+ * @return Pozycja w tablicy haszującej
+ */
+static inline unsigned fibonacciSlot(uint64_t bits, unsigned capacity)
+{
+    // Fibonacci hashing spreads consecutive ids over the whole table; the
+    // high half of the product is used, because the low bits of a pointer
+    // are always zero
+    return (unsigned) ((bits * 0x9E3779B97F4A7C15ULL) >> 32) & (capacity - 1);
+}
+
+/**
+ * @brief Sprawdza, czy tablicę trzeba powiększyć przed dodaniem elementu
+ * @param count - liczba elementów w tablicy
+ * @param capacity - rozmiar tablicy
+ * @return wartość @p true jeśli trzeba, @p false w przeciwnym wypadku
+ */
+static inline bool tableNeedsGrowth(unsigned count, unsigned capacity)
+{
+    // keep the table at most half full, so probe sequences stay short
+    return 2 * (count + 1) > capacity;
+}
+
+/**
+ * @brief Definiuje funkcje tablicy haszującej o elementach typu @p Slot.
+ * Wolna pozycja to element wyzerowany. Usuwanie przesuwa kolejne elementy
+ * wstecz, więc tablica nie zawiera znaczników usuniętych pozycji.
+ * Definiowane funkcje, wszystkie statyczne:
+ * - prefixFind(slots, capacity, key) - pozycja klucza, lub wolna pozycja
+ *   kończąca poszukiwania;
+ * - prefixPlace(slots, capacity, slot) - umieszcza element, którego klucza
+ *   nie ma w tablicy, na pierwszej wolnej pozycji od jego pozycji domowej;
+ * - prefixGrow(&slots, &capacity, initial) - powiększa tablicę dwukrotnie,
+ *   albo do rozmiaru @p initial, i rozmieszcza elementy od nowa; zwraca
+ *   @p false, jeśli zabrakło pamięci;
+ * - prefixErase(slots, capacity, position) - usuwa element z danej pozycji.
+ * @param prefix - przedrostek nazw definiowanych funkcji
+ * @param Slot - typ elementu tablicy
+ * @param Key - typ klucza, porównywalny operatorem ==
+ * @param isEmpty - funkcja Slot -> bool, czy pozycja jest wolna
+ * @param keyOf - funkcja Slot -> Key, klucz zajętej pozycji
+ * @param keyBits - funkcja Key -> uint64_t, klucz zapisany jako liczba
+ */
+#define OPEN_ADDRESSING_TABLE(prefix, Slot, Key, isEmpty, keyOf, keyBits)     \
+static inline unsigned prefix##Find(const Slot *slots, unsigned capacity,     \
+                                    Key key)                                  \
+{                                                                             \
+    unsigned position = fibonacciSlot(keyBits(key), capacity);                \
+                                                                              \
+    while (!isEmpty(slots[position]) && keyOf(slots[position]) != key)        \
+    {                                                                         \
+        position = (position + 1) & (capacity - 1);                           \
+    }                                                                         \
+                                                                              \
+    return position;                                                          \
+}                                                                             \
+                                                                              \
+static inline void prefix##Place(Slot *slots, unsigned capacity, Slot slot)   \
+{                                                                             \
+    unsigned position = fibonacciSlot(keyBits(keyOf(slot)), capacity);        \
+                                                                              \
+    while (!isEmpty(slots[position]))                                         \
+    {                                                                         \
+        position = (position + 1) & (capacity - 1);                           \
+    }                                                                         \
+                                                                              \
+    slots[position] = slot;                                                   \
+}                                                                             \
+                                                                              \
+static inline bool prefix##Grow(Slot **slots, unsigned *capacity,             \
+                                unsigned initial)                             \
+{                                                                             \
+    unsigned oldCapacity = *capacity;                                         \
+    Slot *oldSlots = *slots;                                                  \
+    unsigned newCapacity = oldCapacity == 0 ? initial : 2 * oldCapacity;      \
+                                                                              \
+    Slot *newSlots = calloc(newCapacity, sizeof(Slot));                       \
+    if (newSlots == NULL) return false;                                       \
+                                                                              \
+    for (unsigned i = 0; i < oldCapacity; ++i)                                \
+    {                                                                         \
+        if (!isEmpty(oldSlots[i]))                                            \
+        {                                                                     \
+            prefix##Place(newSlots, newCapacity, oldSlots[i]);                \
+        }                                                                     \
+    }                                                                         \
+                                                                              \
+    free(oldSlots);                                                           \
+    *slots = newSlots;                                                        \
+    *capacity = newCapacity;                                                  \
+    return true;                                                              \
+}                                                                             \
+                                                                              \
+static inline void prefix##Erase(Slot *slots, unsigned capacity,              \
+                                 unsigned hole)                               \
+{                                                                             \
+    static const Slot emptySlot;                                              \
+    unsigned mask = capacity - 1;                                             \
+                                                                              \
+    /* move back every following element of the cluster that may */           \
+    /* fill the hole */                                                       \
+    for (unsigned next = (hole + 1) & mask; !isEmpty(slots[next]);            \
+         next = (next + 1) & mask)                                            \
+    {                                                                         \
+        unsigned home = fibonacciSlot(keyBits(keyOf(slots[next])),            \
+                                      capacity);                              \
+                                                                              \
+        /* the element may move back only if its home is not inside */        \
+        /* (hole, next] */                                                    \
+        if (((next - home) & mask) >= ((next - hole) & mask))                 \
+        {                                                                     \
+            slots[hole] = slots[next];                                        \
+            hole = next;                                                      \
+        }                                                                     \
+    }                                                                         \
+                                                                              \
+    slots[hole] = emptySlot;                                                  \
+}
+
+#endif //DROGI_OPENADDRESSING_H
@@ -0,0 +1,128 @@
+/** @file
+ * Implementacja klasy OutputWriter
+ *
+ * @author Filip Bieńkowski 407686
+ * @copyright Uniwersytet Warszawski
+ */
+
+#include "OutputWriter.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+
+#define OUTPUT_CHUNK (1u << 16)
+#define NUMBER_BUFFER 24
+
+OutputWriter* newOutputWriter(int descriptor)
+{
+    OutputWriter *writer = malloc(sizeof(OutputWriter));
+
+    if (writer == NULL) return NULL;
+
+    writer->buffer = malloc(sizeof(char) * OUTPUT_CHUNK);
+    if (writer->buffer == NULL)
+    {
+        free(writer);
+        return NULL;
+    }
+
+    writer->descriptor = descriptor;
+    writer->capacity = OUTPUT_CHUNK;
+    writer->used = 0;
+
+    return writer;
+}
+
+void removeOutputWriter(OutputWriter *writer)
+{
+    if (writer != NULL)
+    {
+        flushOutput(writer);
+        free(writer->buffer);
+        free(writer);
+    }
+}
+
+/**
+ * @brief Zapisuje dane do pliku, ponawiając zapis, dopóki nie zapisze
+ * wszystkiego
+ * @param descriptor - deskryptor zapisywanego pliku
+ * @param data - zapisywane dane
+ * @param length - liczba zapisywanych znaków
+ * @return false, jeśli zapis się nie powiódł; w przeciwnym wypadku true
+ */
+static bool writeAll(int descriptor, const char *data, size_t length)
+{
+    while (length > 0)
+    {
+        ssize_t count = write(descriptor, data, length);
+
+        if (count < 0)
+        {
+            if (errno == EINTR) continue;
+            return false;
+        }
+
+        data += count;
+        length -= count;
+    }
+
+    return true;
+}
+
+bool flushOutput(OutputWriter *writer)
+{
+    bool written = writeAll(writer->descriptor, writer->buffer, writer->used);
+    writer->used = 0;
+
+    return written;
+}
+
+bool writeOutput(OutputWriter *writer, const char *data, size_t length)
+{
+    if (writer->used + length > writer->capacity)
+    {
+        if (!flushOutput(writer)) return false;
+
+        // there is no point in copying what would fill the buffer anyway
+        if (length >= writer->capacity)
+        {
+            return writeAll(writer->descriptor, data, length);
+        }
+    }
+
+    memcpy(writer->buffer + writer->used, data, length);
+    writer->used += length;
+
+    return true;
+}
+
+bool writeCharacter(OutputWriter *writer, char character)
+{
+    if (writer->used == writer->capacity && !flushOutput(writer)) return false;
+
+    writer->buffer[writer->used++] = character;
+
+    return true;
+}
+
+bool writeNumber(OutputWriter *writer, long number)
+{
+    char digits[NUMBER_BUFFER];
+    size_t begin = NUMBER_BUFFER;
+
+    // the magnitude is taken as unsigned, so the smallest long fits as well
+    unsigned long magnitude = number < 0 ? -(unsigned long) number
+                                         : (unsigned long) number;
+    do
+    {
+        digits[--begin] = (char) ('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude > 0);
+
+    if (number < 0) digits[--begin] = '-';
+
+    return writeOutput(writer, digits + begin, NUMBER_BUFFER - begin);
+}
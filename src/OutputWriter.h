@@ -0,0 +1,93 @@
+/** @file
+ * Interfejs klasy OutputWriter - bufora wyjścia zapisywanego dużymi porcjami
+ *
+ * @author Filip Bieńkowski 407686
+ * @copyright Uniwersytet Warszawski
+ */
+
+#ifndef DROGI_OUTPUTWRITER_H
+#define DROGI_OUTPUTWRITER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @brief Bufor wyjścia. Zbiera wypisywane dane i zapisuje je do pliku jednym
+ * wywołaniem systemowym, gdy bufor się zapełni albo gdy zostanie opróżniony
+ * na żądanie.
+ */
+struct OutputWriter
+{
+    /**
+     * @brief Deskryptor zapisywanego pliku
+     */
+    int descriptor;
+
+    /**
+     * @brief Bufor na dane czekające na zapisanie
+     */
+    char *buffer;
+
+    /**
+     * @brief Rozmiar bufora
+     */
+    size_t capacity;
+
+    /**
+     * @brief Liczba znaków czekających w buforze
+     */
+    size_t used;
+};
+typedef struct OutputWriter OutputWriter;
+
+/**
+ * @brief Stwórz bufor wyjścia do danego pliku
+ * @param descriptor - Deskryptor zapisywanego pliku
+ * @return Wskaźnik na nowy bufor, lub NULL jeśli nie udało się stworzyć
+ */
+OutputWriter* newOutputWriter(int descriptor);
+
+/**
+ * @brief Usuń dany bufor, wcześniej zapisując jego zawartość. Nie zamyka
+ * zapisywanego pliku.
+ * @param writer - Wskaźnik na usuwany bufor
+ */
+void removeOutputWriter(OutputWriter *writer);
+
+/**
+ * @brief Zapisz do pliku całą zawartość bufora. Dane, których nie udało się
+ * zapisać, są porzucane.
+ * @param writer - Wskaźnik na bufor
+ * @return wartość @p true jeśli wszystko zapisano, @p false w przeciwnym wypadku
+ */
+bool flushOutput(OutputWriter *writer);
+
+/**
+ * @brief Dopisz dane do bufora. Dane dłuższe niż bufor są zapisywane od razu.
+ * @param writer - Wskaźnik na bufor
+ * @param data - Dopisywane dane
+ * @param length - Liczba dopisywanych znaków
+ * @return wartość @p false jeśli nie udało się zapisać pełnego bufora,
+ * @p true w przeciwnym wypadku
+ */
+bool writeOutput(OutputWriter *writer, const char *data, size_t length);
+
+/**
+ * @brief Dopisz jeden znak do bufora
+ * @param writer - Wskaźnik na bufor
+ * @param character - Dopisywany znak
+ * @return wartość @p false jeśli nie udało się zapisać pełnego bufora,
+ * @p true w przeciwnym wypadku
+ */
+bool writeCharacter(OutputWriter *writer, char character);
+
+/**
+ * @brief Dopisz do bufora liczbę w zapisie dziesiętnym
+ * @param writer - Wskaźnik na bufor
+ * @param number - Dopisywana liczba
+ * @return wartość @p false jeśli nie udało się zapisać pełnego bufora,
+ * @p true w przeciwnym wypadku
+ */
+bool writeNumber(OutputWriter *writer, long number);
+
+#endif //DROGI_OUTPUTWRITER_H
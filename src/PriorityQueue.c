@@ -0,0 +1,158 @@
+/** @file
+ * Implementacja klasy PriorityQueue oparta o kopiec binarny
+ *
+ * @author Filip Bieńkowski 407686
+ * @copyright Uniwersytet Warszawski
+ */
+
+#include "PriorityQueue.h"
+#include "map.h"
+
+#include <stdlib.h>
+
+#define INITIAL_QUEUE_CAPACITY 64
+
+/**
+ * @brief Umieszcza element na podanej pozycji kopca i aktualizuje pozycję miasta
+ * @param queue - wskaźnik na kolejkę
+ * @param position - pozycja w tablicy elementów
+ * @param entry - umieszczany element
+ */
+static inline void placeEntry(PriorityQueue *queue, unsigned position,
+                              QueueEntry entry)
+{
+    queue->entries[position] = entry;
+    entry.city->queueIndex[queue->direction] = position;
+}
+
+/**
+ * @brief Przesuwa element w górę kopca, aż przywróci jego porządek
+ * @param queue - wskaźnik na kolejkę
+ * @param position - pozycja przesuwanego elementu
+ */
+static void siftUp(PriorityQueue *queue, unsigned position)
+{
+    QueueEntry moved = queue->entries[position];
+
+    while (position > 0)
+    {
+        unsigned parent = (position - 1) / 2;
+        if (queue->entries[parent].key <= moved.key) break;
+        placeEntry(queue, position, queue->entries[parent]);
+        position = parent;
+    }
+
+    placeEntry(queue, position, moved);
+}
+
+/**
+ * @brief Przesuwa element w dół kopca, aż przywróci jego porządek
+ * @param queue - wskaźnik na kolejkę
+ * @param position - pozycja przesuwanego elementu
+ */
+static void siftDown(PriorityQueue *queue, unsigned position)
+{
+    QueueEntry moved = queue->entries[position];
+
+    while (true)
+    {
+        unsigned child = 2 * position + 1;
+        if (child >= queue->size) break;
+        // pick the smaller of two children
+        if (child + 1 < queue->size &&
+            queue->entries[child + 1].key < queue->entries[child].key)
+        {
+            ++child;
+        }
+        if (moved.key <= queue->entries[child].key) break;
+        placeEntry(queue, position, queue->entries[child]);
+        position = child;
+    }
+
+    placeEntry(queue, position, moved);
+}
+
+PriorityQueue* newPriorityQueue(unsigned direction)
+{
+    PriorityQueue *queue = malloc(sizeof(PriorityQueue));
+
+    if (queue == NULL) return NULL;
+
+    queue->entries = NULL;
+    queue->size = 0;
+    queue->capacity = 0;
+    queue->direction = direction;
+
+    return queue;
+}
+
+void removePriorityQueue(PriorityQueue *queue)
+{
+    if (queue != NULL)
+    {
+        free(queue->entries);
+        free(queue);
+    }
+}
+
+void clearQueue(PriorityQueue *queue)
+{
+    queue->size = 0;
+}
+
+bool isQueueEmpty(PriorityQueue *queue)
+{
+    return queue->size == 0;
+}
+
+bool pushOrDecrease(PriorityQueue *queue, City *city,
+                    unsigned long long key)
+{
+    unsigned position = city->queueIndex[queue->direction];
+
+    if (position != NOT_QUEUED)
+    {
+        queue->entries[position].key = key;
+        siftUp(queue, position);
+        return true;
+    }
+
+    if (queue->size == queue->capacity)
+    {
+        // grow geometrically, so pushing is amortized O(1) apart from sifting
+        unsigned newCapacity = queue->capacity == 0 ? INITIAL_QUEUE_CAPACITY
+                                                    : 2 * queue->capacity;
+        QueueEntry *newEntries = realloc(queue->entries,
+                                         sizeof(QueueEntry) * newCapacity);
+        if (newEntries == NULL) return false;
+        queue->entries = newEntries;
+        queue->capacity = newCapacity;
+    }
+
+    QueueEntry entry = {key, city};
+    queue->entries[queue->size] = entry;
+    queue->size++;
+    siftUp(queue, queue->size - 1);
+
+    return true;
+}
+
+unsigned long long minKey(PriorityQueue *queue)
+{
+    return queue->entries[0].key;
+}
+
+City *popMin(PriorityQueue *queue)
+{
+    City *lowest = queue->entries[0].city;
+    lowest->queueIndex[queue->direction] = NOT_QUEUED;
+
+    queue->size--;
+    if (queue->size > 0)
+    {
+        placeEntry(queue, 0, queue->entries[queue->size]);
+        siftDown(queue, 0);
+    }
+
+    return lowest;
+}
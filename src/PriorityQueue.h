@@ -0,0 +1,130 @@
+/** @file
+ * Interfejs klasy PriorityQueue - kopca binarnego miast z operacją
+ * zmniejszania klucza
+ *
+ * @author Filip Bieńkowski 407686
+ * @copyright Uniwersytet Warszawski
+ */
+
+#ifndef DROGI_PRIORITYQUEUE_H
+#define DROGI_PRIORITYQUEUE_H
+
+#include <stdbool.h>
+#include <limits.h>
+
+/**
+ * @brief Wartość pola queueIndex miasta, które nie znajduje się w kolejce
+ */
+#define NOT_QUEUED UINT_MAX
+
+/**
+ * @brief Numer kolejki wyszukiwania od miasta początkowego
+ */
+#define FORWARD_QUEUE 0
+
+/**
+ * @brief Numer kolejki wyszukiwania od miasta końcowego
+ */
+#define BACKWARD_QUEUE 1
+
+struct City;
+
+/**
+ * @brief Element kopca: miasto wraz z jego kluczem
+ */
+struct QueueEntry
+{
+    /**
+     * @brief Klucz, według którego porządkowany jest kopiec
+     */
+    unsigned long long key;
+
+    /**
+     * @brief Miasto przechowywane w kopcu
+     */
+    struct City *city;
+};
+typedef struct QueueEntry QueueEntry;
+
+/**
+ * @brief Kopiec binarny typu min. Pozycja miasta w kopcu jest pamiętana
+ * w polu queueIndex[direction] miasta, dzięki czemu zmniejszenie klucza działa
+ * w czasie logarytmicznym.
+ */
+struct PriorityQueue
+{
+    /**
+     * @brief Tablica elementów kopca
+     */
+    QueueEntry *entries;
+
+    /**
+     * @brief Liczba elementów w kopcu
+     */
+    unsigned size;
+
+    /**
+     * @brief Rozmiar zaalokowanej tablicy elementów
+     */
+    unsigned capacity;
+
+    /**
+     * @brief Numer kolejki: FORWARD_QUEUE lub BACKWARD_QUEUE. Wybiera pole
+     * queueIndex miasta, w którym jest pamiętana jego pozycja
+     */
+    unsigned direction;
+};
+typedef struct PriorityQueue PriorityQueue;
+
+/**
+ * @brief Stwórz nową, pustą kolejkę
+ * @param direction - FORWARD_QUEUE lub BACKWARD_QUEUE
+ * @return Wskaźnik na nową kolejkę, lub NULL jeśli nie udało się stworzyć
+ */
+PriorityQueue* newPriorityQueue(unsigned direction);
+
+/**
+ * @brief Usuń daną kolejkę. Nie usuwa przechowywanych miast.
+ * @param queue - Wskaźnik na usuwaną kolejkę
+ */
+void removePriorityQueue(PriorityQueue *queue);
+
+/**
+ * @brief Opróżnij kolejkę, zachowując zaalokowaną pamięć
+ * @param queue - Wskaźnik na kolejkę
+ */
+void clearQueue(PriorityQueue *queue);
+
+/**
+ * @brief Sprawdź czy kolejka jest pusta
+ * @param queue - Wskaźnik na kolejkę
+ * @return Wartość @p true jeśli jest pusta, @p false w przeciwnym wypadku
+ */
+bool isQueueEmpty(PriorityQueue *queue);
+
+/**
+ * @brief Włóż miasto do kolejki, lub zmniejsz jego klucz jeśli już w niej jest
+ * @param queue - Wskaźnik na kolejkę
+ * @param city - Wskaźnik na miasto. Pole queueIndex musi być równe NOT_QUEUED,
+ * jeśli miasta nie ma w kolejce
+ * @param key - Nowy klucz, nie większy od dotychczasowego
+ * @return wartość @p true jeśli się udało, @p false jeśli zabrakło pamięci
+ */
+bool pushOrDecrease(PriorityQueue *queue, struct City *city,
+                    unsigned long long key);
+
+/**
+ * @brief Podaj najmniejszy klucz w kolejce
+ * @param queue - Wskaźnik na niepustą kolejkę
+ * @return Klucz miasta, które zostanie wyjęte jako następne
+ */
+unsigned long long minKey(PriorityQueue *queue);
+
+/**
+ * @brief Wyjmij z kolejki miasto o najmniejszym kluczu
+ * @param queue - Wskaźnik na niepustą kolejkę
+ * @return Wskaźnik na wyjęte miasto
+ */
+struct City *popMin(PriorityQueue *queue);
+
+#endif //DROGI_PRIORITYQUEUE_H
@@ -0,0 +1,127 @@
+/** @file
+ * Implementacja klasy RoadIndex oparta o adresowanie otwarte
+ *
+ * @author Filip Bieńkowski 407686
+ * @copyright Uniwersytet Warszawski
+ */
+
+#include "RoadIndex.h"
+#include "map.h"
+#include "OpenAddressing.h"
+
+#include <stdlib.h>
+
+#define INITIAL_INDEX_CAPACITY 64
+
+/**
+ * @brief Klucz nieuporządkowanej pary numerów miast
+ * @param idA - numer jednego miasta
+ * @param idB - numer drugiego miasta
+ * @return Klucz niezależny od kolejności numerów
+ */
+static inline uint64_t pairKey(uint32_t idA, uint32_t idB)
+{
+    return idA < idB ? ((uint64_t) idA << 32) | idB
+                     : ((uint64_t) idB << 32) | idA;
+}
+
+/**
+ * @brief Sprawdza, czy pozycja tablicy jest wolna
+ * @param entry - element tablicy
+ * @return wartość @p true jeśli jest wolna, @p false w przeciwnym wypadku
+ */
+static inline bool entryIsEmpty(RoadIndexEntry entry)
+{
+    return entry.road == NULL;
+}
+
+/**
+ * @brief Klucz elementu tablicy
+ * @param entry - zajęty element tablicy
+ * @return Klucz pary końców odcinka
+ */
+static inline uint64_t entryKey(RoadIndexEntry entry)
+{
+    return entry.key;
+}
+
+/**
+ * @brief Klucz pary zapisany jako liczba
+ * @param key - klucz pary
+ * @return Ten sam klucz
+ */
+static inline uint64_t pairBits(uint64_t key)
+{
+    return key;
+}
+
+OPEN_ADDRESSING_TABLE(entries, RoadIndexEntry, uint64_t,
+                      entryIsEmpty, entryKey, pairBits)
+
+RoadIndex* newRoadIndex(void)
+{
+    RoadIndex *index = malloc(sizeof(RoadIndex));
+
+    if (index == NULL) return NULL;
+
+    index->entries = NULL;
+    index->size = 0;
+    index->capacity = 0;
+
+    return index;
+}
+
+void removeRoadIndex(RoadIndex *index)
+{
+    if (index != NULL)
+    {
+        free(index->entries);
+        free(index);
+    }
+}
+
+bool insertRoad(RoadIndex *index, Road *road)
+{
+    if (tableNeedsGrowth(index->size, index->capacity) &&
+        !entriesGrow(&index->entries, &index->capacity, INITIAL_INDEX_CAPACITY))
+    {
+        return false;
+    }
+
+    RoadIndexEntry entry;
+    entry.key = pairKey(road->cityA->id, road->cityB->id);
+    entry.road = road;
+
+    entriesPlace(index->entries, index->capacity, entry);
+    index->size++;
+    return true;
+}
+
+void eraseRoad(RoadIndex *index, Road *road)
+{
+    unsigned position = entriesFind(index->entries, index->capacity,
+                                    pairKey(road->cityA->id, road->cityB->id));
+
+    entriesErase(index->entries, index->capacity, position);
+    index->size--;
+}
+
+Road *lookupRoad(RoadIndex *index, uint32_t idA, uint32_t idB)
+{
+    if (index->size == 0) return NULL;
+
+    return index->entries[entriesFind(index->entries, index->capacity,
+                                      pairKey(idA, idB))].road;
+}
+
+void forEachRoad(RoadIndex *index, void (*visit)(Road *road, void *data),
+                 void *data)
+{
+    for (unsigned i = 0; i < index->capacity; ++i)
+    {
+        if (!entryIsEmpty(index->entries[i]))
+        {
+            visit(index->entries[i].road, data);
+        }
+    }
+}
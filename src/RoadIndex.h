@@ -0,0 +1,105 @@
+/** @file
+ * Interfejs klasy RoadIndex - tablicy haszującej odcinków dróg
+ * indeksowanej nieuporządkowaną parą numerów ich końców
+ *
+ * @author Filip Bieńkowski 407686
+ * @copyright Uniwersytet Warszawski
+ */
+
+#ifndef DROGI_ROADINDEX_H
+#define DROGI_ROADINDEX_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+struct Road;
+
+/**
+ * @brief Element tablicy: odcinek drogi wraz z kluczem pary jego końców
+ */
+struct RoadIndexEntry
+{
+    /**
+     * @brief Mniejszy numer końca odcinka w starszych 32 bitach, większy
+     * w młodszych
+     */
+    uint64_t key;
+
+    /**
+     * @brief Odcinek drogi, lub NULL jeśli pozycja jest wolna
+     */
+    struct Road *road;
+};
+typedef struct RoadIndexEntry RoadIndexEntry;
+
+/**
+ * @brief Tablica haszująca z adresowaniem otwartym i liniowym próbkowaniem.
+ * Usuwanie przesuwa kolejne elementy wstecz, więc tablica nie zawiera
+ * znaczników usuniętych pozycji.
+ */
+struct RoadIndex
+{
+    /**
+     * @brief Tablica elementów; jej rozmiar jest potęgą dwójki
+     */
+    RoadIndexEntry *entries;
+
+    /**
+     * @brief Liczba odcinków w tablicy
+     */
+    unsigned size;
+
+    /**
+     * @brief Rozmiar tablicy elementów
+     */
+    unsigned capacity;
+};
+typedef struct RoadIndex RoadIndex;
+
+/**
+ * @brief Stwórz nowy, pusty indeks
+ * @return Wskaźnik na nowy indeks, lub NULL jeśli nie udało się stworzyć
+ */
+RoadIndex* newRoadIndex(void);
+
+/**
+ * @brief Usuń dany indeks. Nie usuwa przechowywanych odcinków.
+ * @param index - Wskaźnik na usuwany indeks
+ */
+void removeRoadIndex(RoadIndex *index);
+
+/**
+ * @brief Dodaj odcinek do indeksu
+ * @param index - Wskaźnik na indeks
+ * @param road - Odcinek, między którego końcami nie ma jeszcze w indeksie
+ * żadnego odcinka
+ * @return wartość @p true jeśli się udało, @p false jeśli zabrakło pamięci
+ */
+bool insertRoad(RoadIndex *index, struct Road *road);
+
+/**
+ * @brief Usuń odcinek z indeksu
+ * @param index - Wskaźnik na indeks
+ * @param road - Odcinek znajdujący się w indeksie
+ */
+void eraseRoad(RoadIndex *index, struct Road *road);
+
+/**
+ * @brief Znajdź odcinek między miastami o podanych numerach
+ * @param index - Wskaźnik na indeks
+ * @param idA - Numer jednego końca, w dowolnej kolejności
+ * @param idB - Numer drugiego końca
+ * @return Wskaźnik na odcinek, lub NULL jeśli go nie ma
+ */
+struct Road *lookupRoad(RoadIndex *index, uint32_t idA, uint32_t idB);
+
+/**
+ * @brief Wywołaj funkcję dla każdego odcinka w indeksie, w dowolnej kolejności
+ * @param index - Wskaźnik na indeks
+ * @param visit - Funkcja wywoływana dla odcinka; nie może zmieniać indeksu
+ * @param data - Wskaźnik przekazywany funkcji @p visit
+ */
+void forEachRoad(RoadIndex *index,
+                 void (*visit)(struct Road *road, void *data), void *data);
+
+#endif //DROGI_ROADINDEX_H
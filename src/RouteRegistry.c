@@ -0,0 +1,122 @@
+/** @file
+ * Implementacja klasy RouteRegistry
+ *
+ * @author Filip Bieńkowski 407686
+ * @copyright Uniwersytet Warszawski
+ */
+
+#include "RouteRegistry.h"
+#include "map.h"
+#include "OpenAddressing.h"
+
+#include <stdlib.h>
+
+#define INITIAL_REGISTRY_CAPACITY 16
+
+/**
+ * @brief Element tablicy haszującej: droga krajowa, NULL jeśli pozycja jest
+ * wolna
+ */
+typedef Route *RouteSlot;
+
+/**
+ * @brief Sprawdza, czy pozycja tablicy haszującej jest wolna
+ * @param route - element tablicy
+ * @return wartość @p true jeśli jest wolna, @p false w przeciwnym wypadku
+ */
+static inline bool slotIsEmpty(RouteSlot route)
+{
+    return route == NULL;
+}
+
+/**
+ * @brief Numer drogi zajmującej pozycję tablicy haszującej
+ * @param route - zajęty element tablicy
+ * @return Numer drogi krajowej
+ */
+static inline unsigned slotId(RouteSlot route)
+{
+    return route->id;
+}
+
+/**
+ * @brief Numer drogi zapisany jako liczba 64-bitowa
+ * @param id - numer drogi krajowej
+ * @return Ten sam numer
+ */
+static inline uint64_t idBits(unsigned id)
+{
+    return id;
+}
+
+OPEN_ADDRESSING_TABLE(slots, RouteSlot, unsigned, slotIsEmpty, slotId, idBits)
+
+RouteRegistry* newRouteRegistry(void)
+{
+    RouteRegistry *registry = malloc(sizeof(RouteRegistry));
+
+    if (registry == NULL) return NULL;
+
+    registry->slots = NULL;
+    registry->capacity = 0;
+    registry->live = NULL;
+    registry->liveCount = 0;
+    registry->liveCapacity = 0;
+
+    return registry;
+}
+
+void removeRouteRegistry(RouteRegistry *registry)
+{
+    if (registry != NULL)
+    {
+        free(registry->slots);
+        free(registry->live);
+        free(registry);
+    }
+}
+
+Route *lookupRoute(RouteRegistry *registry, unsigned id)
+{
+    if (registry->liveCount == 0) return NULL;
+
+    return registry->slots[slotsFind(registry->slots, registry->capacity, id)];
+}
+
+bool registerRoute(RouteRegistry *registry, Route *route)
+{
+    if (registry->liveCount == registry->liveCapacity)
+    {
+        unsigned newCapacity = registry->liveCapacity == 0
+                               ? INITIAL_REGISTRY_CAPACITY
+                               : 2 * registry->liveCapacity;
+        Route **newLive = realloc(registry->live, sizeof(Route *) * newCapacity);
+        if (newLive == NULL) return false;
+
+        registry->live = newLive;
+        registry->liveCapacity = newCapacity;
+    }
+
+    if (tableNeedsGrowth(registry->liveCount, registry->capacity) &&
+        !slotsGrow(&registry->slots, &registry->capacity,
+                   INITIAL_REGISTRY_CAPACITY))
+    {
+        return false;
+    }
+
+    slotsPlace(registry->slots, registry->capacity, route);
+    route->position = registry->liveCount;
+    registry->live[registry->liveCount++] = route;
+    return true;
+}
+
+void unregisterRoute(RouteRegistry *registry, Route *route)
+{
+    slotsErase(registry->slots, registry->capacity,
+               slotsFind(registry->slots, registry->capacity, route->id));
+
+    // the last live route takes the freed place on the live list
+    Route *moved = registry->live[--registry->liveCount];
+    registry->live[route->position] = moved;
+    moved->position = route->position;
+}
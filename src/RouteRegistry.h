@@ -0,0 +1,87 @@
+/** @file
+ * Interfejs klasy RouteRegistry - rejestru dróg krajowych indeksowanego
+ * ich numerami
+ *
+ * @author Filip Bieńkowski 407686
+ * @copyright Uniwersytet Warszawski
+ */
+
+#ifndef DROGI_ROUTEREGISTRY_H
+#define DROGI_ROUTEREGISTRY_H
+
+#include <stdbool.h>
+
+struct Route;
+
+/**
+ * @brief Rejestr dróg krajowych. Tablica haszująca z adresowaniem otwartym
+ * i liniowym próbkowaniem odnajduje drogę po numerze, a osobna zwarta tablica
+ * zawiera wyłącznie istniejące drogi, więc operacje dotyczące wszystkich
+ * dróg nie zależą od zakresu numerów.
+ */
+struct RouteRegistry
+{
+    /**
+     * @brief Tablica haszująca; jej rozmiar jest potęgą dwójki, a wolne
+     * pozycje zawierają NULL
+     */
+    struct Route **slots;
+
+    /**
+     * @brief Rozmiar tablicy slots
+     */
+    unsigned capacity;
+
+    /**
+     * @brief Istniejące drogi krajowe, w dowolnej kolejności
+     */
+    struct Route **live;
+
+    /**
+     * @brief Liczba istniejących dróg krajowych
+     */
+    unsigned liveCount;
+
+    /**
+     * @brief Rozmiar zaalokowanej tablicy live
+     */
+    unsigned liveCapacity;
+};
+typedef struct RouteRegistry RouteRegistry;
+
+/**
+ * @brief Stwórz nowy, pusty rejestr
+ * @return Wskaźnik na nowy rejestr, lub NULL jeśli nie udało się stworzyć
+ */
+RouteRegistry* newRouteRegistry(void);
+
+/**
+ * @brief Usuń dany rejestr. Nie usuwa zarejestrowanych dróg.
+ * @param registry - Wskaźnik na usuwany rejestr
+ */
+void removeRouteRegistry(RouteRegistry *registry);
+
+/**
+ * @brief Znajdź drogę krajową o podanym numerze
+ * @param registry - Wskaźnik na rejestr
+ * @param id - Numer drogi krajowej
+ * @return Wskaźnik na drogę, lub NULL jeśli jej nie ma
+ */
+struct Route *lookupRoute(RouteRegistry *registry, unsigned id);
+
+/**
+ * @brief Zarejestruj drogę krajową pod numerem zapisanym w jej polu id
+ * @param registry - Wskaźnik na rejestr
+ * @param route - Droga, której numer jest różny od 0 i jeszcze niezajęty
+ * @return wartość @p true jeśli się udało, @p false jeśli zabrakło pamięci
+ */
+bool registerRoute(RouteRegistry *registry, struct Route *route);
+
+/**
+ * @brief Wyrejestruj drogę krajową. Nie usuwa samej drogi.
+ * @param registry - Wskaźnik na rejestr
+ * @param route - Zarejestrowana droga
+ */
+void unregisterRoute(RouteRegistry *registry, struct Route *route);
+
+#endif //DROGI_ROUTEREGISTRY_H
@@ -0,0 +1,93 @@
+/** @file
+ * Implementacja klasy StringArena
+ *
+ * @author Filip Bieńkowski 407686
+ * @copyright Uniwersytet Warszawski
+ */
+
+#include "StringArena.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define ARENA_BLOCK_SIZE 65536
+
+/**
+ * @brief Alokuje nowy, pusty blok
+ * @param capacity - rozmiar bloku w bajtach
+ * @return Wskaźnik na blok, lub NULL jeśli zabrakło pamięci
+ */
+static ArenaBlock *newBlock(size_t capacity)
+{
+    ArenaBlock *block = malloc(sizeof(ArenaBlock) + capacity);
+    if (block == NULL) return NULL;
+
+    block->next = NULL;
+    block->used = 0;
+    block->capacity = capacity;
+    return block;
+}
+
+StringArena* newStringArena(void)
+{
+    StringArena *arena = malloc(sizeof(StringArena));
+
+    if (arena == NULL) return NULL;
+
+    arena->current = NULL;
+    return arena;
+}
+
+void removeStringArena(StringArena *arena)
+{
+    if (arena == NULL) return;
+
+    while (arena->current != NULL)
+    {
+        ArenaBlock *next = arena->current->next;
+        free(arena->current);
+        arena->current = next;
+    }
+
+    free(arena);
+}
+
+const char *storeString(StringArena *arena, const char *string)
+{
+    size_t size = strlen(string) + 1;
+    ArenaBlock *block = arena->current;
+
+    if (block == NULL || block->capacity - block->used < size)
+    {
+        if (size > ARENA_BLOCK_SIZE / 4)
+        {
+            // a long string gets its own block, which goes behind the
+            // current one so the space left there is not wasted
+            block = newBlock(size);
+            if (block == NULL) return NULL;
+
+            if (arena->current == NULL)
+            {
+                arena->current = block;
+            }
+            else
+            {
+                block->next = arena->current->next;
+                arena->current->next = block;
+            }
+        }
+        else
+        {
+            block = newBlock(ARENA_BLOCK_SIZE);
+            if (block == NULL) return NULL;
+
+            block->next = arena->current;
+            arena->current = block;
+        }
+    }
+
+    char *copy = block->data + block->used;
+    memcpy(copy, string, size);
+    block->used += size;
+    return copy;
+}
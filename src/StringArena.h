@@ -0,0 +1,74 @@
+/** @file
+ * Interfejs klasy StringArena - obszaru pamięci przechowującego napisy
+ * jeden za drugim
+ *
+ * @author Filip Bieńkowski 407686
+ * @copyright Uniwersytet Warszawski
+ */
+
+#ifndef DROGI_STRINGARENA_H
+#define DROGI_STRINGARENA_H
+
+#include <stddef.h>
+
+/**
+ * @brief Blok pamięci areny
+ */
+struct ArenaBlock
+{
+    /**
+     * @brief Poprzednio zaalokowany blok
+     */
+    struct ArenaBlock *next;
+
+    /**
+     * @brief Liczba zajętych bajtów bloku
+     */
+    size_t used;
+
+    /**
+     * @brief Rozmiar bloku w bajtach
+     */
+    size_t capacity;
+
+    /**
+     * @brief Przechowywane napisy
+     */
+    char data[];
+};
+typedef struct ArenaBlock ArenaBlock;
+
+/**
+ * @brief Arena napisów. Napisy nie są przenoszone ani zwalniane pojedynczo,
+ * więc wskaźniki na nie pozostają ważne do usunięcia całej areny.
+ */
+struct StringArena
+{
+    /**
+     * @brief Blok, z którego przydzielane są kolejne napisy
+     */
+    ArenaBlock *current;
+};
+typedef struct StringArena StringArena;
+
+/**
+ * @brief Stwórz nową, pustą arenę
+ * @return Wskaźnik na nową arenę, lub NULL jeśli nie udało się stworzyć
+ */
+StringArena* newStringArena(void);
+
+/**
+ * @brief Usuń arenę wraz ze wszystkimi przechowywanymi napisami
+ * @param arena - Wskaźnik na usuwaną arenę
+ */
+void removeStringArena(StringArena *arena);
+
+/**
+ * @brief Skopiuj napis do areny
+ * @param arena - Wskaźnik na arenę
+ * @param string - Kopiowany napis
+ * @return Wskaźnik na kopię, lub NULL jeśli zabrakło pamięci
+ */
+const char *storeString(StringArena *arena, const char *string);
+
+#endif //DROGI_STRINGARENA_H
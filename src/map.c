@@ -7,10 +7,11 @@
 
 #include "map.h"
 #include "map_operations.h"
+#include "map_contraction.h"
+#include "map_adjacency.h"
 
 #include <stdlib.h>
 #include <string.h>
-#include <stdio.h>
 
 Map *newMap(void)
 {
@@ -19,83 +20,119 @@ Map *newMap(void)
     if (newMap != NULL)
     {
         newMap->cities = newDictionary();
-
-        for (int i = 0; i < ROUTES_AMOUNT; ++i)
+        newMap->queue = newPriorityQueue(FORWARD_QUEUE);
+        newMap->queueBack = newPriorityQueue(BACKWARD_QUEUE);
+        newMap->roadIndex = newRoadIndex();
+        newMap->names = newStringArena();
+        newMap->cityPool = newObjectPool(sizeof(City));
+        newMap->roadPool = newObjectPool(sizeof(Road));
+        newMap->routes = newRouteRegistry();
+        if (newMap->cities == NULL || newMap->queue == NULL ||
+            newMap->queueBack == NULL || newMap->roadIndex == NULL ||
+            newMap->names == NULL || newMap->cityPool == NULL ||
+            newMap->roadPool == NULL || newMap->routes == NULL)
         {
-            newMap->routes[i] = NULL;
+            if (newMap->cities != NULL) removeDictionary(newMap->cities);
+            removePriorityQueue(newMap->queue);
+            removePriorityQueue(newMap->queueBack);
+            removeRoadIndex(newMap->roadIndex);
+            removeStringArena(newMap->names);
+            removeObjectPool(newMap->cityPool);
+            removeObjectPool(newMap->roadPool);
+            removeRouteRegistry(newMap->routes);
+            free(newMap);
+            return NULL;
         }
+
+        newMap->searchEpoch = 0;
+        newMap->blockedCities = NULL;
+        newMap->searchList = NULL;
+        newMap->searchListSize = 0;
+        newMap->searchListCapacity = 0;
+        newMap->searchMode = SEARCH_DIJKSTRA;
+        newMap->graphVersion = 0;
+        newMap->roadAdditions = 0;
+        newMap->landmarks = NULL;
+        newMap->hierarchy = NULL;
+        newMap->cityById = NULL;
+        newMap->cityCount = 0;
+        newMap->cityByIdCapacity = 0;
+        newMap->adjacency = NULL;
     }
 
     return newMap;
 }
 
-void deleteMap(Map *map)
+/**
+ * @brief Zwalnia pamięć odcinka drogi przy usuwaniu mapy
+ * @param road -- wskaźnik na odcinek
+ * @param data -- wskaźnik na usuwaną mapę
+ */
+static void releaseRoad(Road *road, void *data)
 {
-    // An array for remembering roads to be removed
-    Road **roadsToRemove = malloc(sizeof(Road*) * 0);
-    int sizeOfRemove = 0;
+    Map *map = data;
 
+    // pooled roads themselves go away with their pool
+    free(road->routes);
+    if (!POOL_RELEASES_OBJECTS) poolFree(map->roadPool, road);
+}
+
+void deleteMap(Map *map)
+{
     if (map != NULL)
     {
-        for (int k = 0; k < HASHSIZE; ++k)
+        for (uint32_t id = 0; id < map->cityCount; ++id)
         {
-            dNode *current;
-            for (current = map->cities->nodes[k];
-                 current != NULL; current = current->next)
-            {
-                RoadList *actRoad = current->this->roads;
-                while (actRoad != NULL)
-                {
-                    if (!actRoad->this->queued)
-                    {
-                        // remember to remove this road later
-                        ++sizeOfRemove;
-                        roadsToRemove = realloc(roadsToRemove,
-                                                sizeOfRemove *
-                                                (sizeof(Road *)));
-                        roadsToRemove[sizeOfRemove - 1] = actRoad->this;
-                        actRoad->this->queued = true;
-                    }
-                    RoadList *remove = actRoad;
-                    actRoad = actRoad->next;
-                    free(remove); // remove RoadList
-                }
-                free(current->this->name);
-                free(current->this); // remove City
-            }
+            City *city = map->cityById[id];
+            free(city->roads);
+            free(city->landmarkDistances);
+            if (!POOL_RELEASES_OBJECTS) poolFree(map->cityPool, city);
         }
 
-        int j = 0;
-        for (; j < sizeOfRemove; ++j)
-        {
-            free(roadsToRemove[j]); // remove road
-        }
-        free(roadsToRemove);
+        // the road index holds every road exactly once
+        forEachRoad(map->roadIndex, releaseRoad, map);
 
-        for (int i = 0; i < ROUTES_AMOUNT; ++i) // remove routes
+        for (unsigned i = 0; i < map->routes->liveCount; ++i) // remove routes
         {
-            if (map->routes[i] != NULL)
-            {
-                free(map->routes[i]->howTheWayGoes);
-                free(map->routes[i]);
-            }
+            freeRoute(map->routes->live[i]);
         }
+        removeRouteRegistry(map->routes);
+        removeContractionHierarchy(map);
+        removeAdjacency(map);
+        free(map->cityById);
         removeDictionary(map->cities);
+        removePriorityQueue(map->queue);
+        removePriorityQueue(map->queueBack);
+        removeRoadIndex(map->roadIndex);
+        removeStringArena(map->names); // all city names at once
+        removeObjectPool(map->cityPool);
+        removeObjectPool(map->roadPool);
+        free(map->landmarks);
+        free(map->searchList);
         free(map);
     }
 }
 
+void setSearchMode(Map *map, SearchMode mode)
+{
+    map->searchMode = mode;
+}
+
 bool addRoad(Map *map, const char *city1, const char *city2,
              unsigned length, int builtYear)
 {
     City *cityA = NULL;
     City *cityB = NULL;
+    uint64_t hashA = 0;
+    uint64_t hashB = 0;
 
     if (strcmp(city1, city2) != 0)
     {
         // different names, so it`s ok
-        cityA = findCity(map, city1);
-        cityB = findCity(map, city2);
+        hashA = hashKey(city1);
+        hashB = hashKey(city2);
+        cityA = findCityHashed(map, city1, hashA);
+        cityB = findCityHashed(map, city2, hashB);
     }
     else
     {
@@ -117,14 +154,15 @@ bool addRoad(Map *map, const char *city1, const char *city2,
         return false;
     }
 
-    if (findRoadBetweenCities(map, city1, city2) != NULL)
+    if (cityA != NULL && cityB != NULL &&
+        findRoadBetween(map, cityA, cityB) != NULL)
     {
         return false;
     }
 
     if (cityA == NULL)
     {
-        cityA = makeNewCity(map, city1);
+        cityA = makeNewCity(map, city1, hashA);
         if (cityA == NULL)
         {
             return false;
@@ -133,14 +171,14 @@ bool addRoad(Map *map, const char *city1, const char *city2,
 
     if (cityB == NULL)
     {
-        cityB = makeNewCity(map, city2);
+        cityB = makeNewCity(map, city2, hashB);
         if (cityB == NULL)
         {
             return false;
         }
     }
 
-    bool success = makeNewRoad(cityA, cityB, length, builtYear);
+    bool success = makeNewRoad(map, cityA, cityB, length, builtYear);
 
     return success;
 }
@@ -156,20 +194,19 @@ bool removeRoad(Map *map, const char *city1, const char *city2)
 
     else
     {
-        City *cityA = road->cityA;
-        City *cityB = road->cityB;
-        unsigned length = road->length;
-        int year = road->year; // in case we put it back
-        removeFromRoadList(road, cityA);
-        removeFromRoadList(road, cityB);
-        free(road);
+        // searches for detours must not use the road, so it is detached
+        // first and kept until we know whether it goes away
+        detachRoad(map, road);
 
-        if (!checkRoutesAfterRoadRemoval(map, cityA, cityB))
+        if (!checkRoutesAfterRoadRemoval(map, road))
         {
-            addRoad(map, city1, city2, length, year);
+            // the arrays and the index just shrank, so this can not fail
+            attachRoad(map, road);
             return false;
         }
 
+        free(road->routes);
+        poolFree(map->roadPool, road);
         return true;
     }
 }
@@ -189,7 +226,7 @@ bool repairRoad(Map *map, const char *city1, const char *city2, int repairYear)
         {
             return false;
         }
-        repairedRoad->year = repairYear;
+        setRoadYear(map, repairedRoad, repairYear);
         return true;
     }
     else
@@ -200,12 +237,12 @@ bool repairRoad(Map *map, const char *city1, const char *city2, int repairYear)
 
 bool newRoute(Map *map, unsigned routeId, const char *city1, const char *city2)
 {
-    if (routeId >= ROUTES_AMOUNT || routeId < 1)
+    if (routeId < 1)
     {
         return false;
     }
 
-    if (map->routes[routeId] != NULL)
+    if (lookupRoute(map->routes, routeId) != NULL)
     {
         return false;
     }
@@ -218,48 +255,55 @@ bool newRoute(Map *map, unsigned routeId, const char *city1, const char *city2)
         return false;
     }
 
-    Route *newRoute = dkstra(map, routeId, start, finish);
+    prepareSearch(map, routeId);
+    Route *newRoute = findRoute(map, routeId, start, finish);
 
     if (newRoute == NULL)
     {
         return false;
     }
-    else
+    newRoute->id = routeId;
+    if (!linkRouteSegments(newRoute, newRoute->roads, newRoute->length - 1))
     {
-        map->routes[routeId] = newRoute;
-        return true;
+        freeRoute(newRoute);
+        return false;
     }
+    if (!registerRoute(map->routes, newRoute))
+    {
+        unlinkRouteSegments(newRoute, newRoute->roads, newRoute->length - 1);
+        freeRoute(newRoute);
+        return false;
+    }
+
+    return true;
 }
 
 bool extendRoute(Map *map, unsigned routeId, const char *city)
 {
-    if (routeId >= ROUTES_AMOUNT || routeId < 1)
+    if (routeId < 1)
     {
         return false;
     }
 
-    Route *oldRoute = map->routes[routeId];
+    Route *oldRoute = lookupRoute(map->routes, routeId);
     if (oldRoute == NULL) return false;
 
     City *newFinish = findCity(map, city);
     if (newFinish == NULL) return false;
 
-    if (findCityIndex(map->routes[routeId], newFinish) != INFINITY) return false;
+    if (findCityIndex(oldRoute, newFinish) != INFINITY) return false;
 
-    Route *newPart = dkstra(map, routeId,
+    prepareSearch(map, routeId);
+    Route *newPart = findRoute(map, routeId,
                             oldRoute->howTheWayGoes[oldRoute->length - 1],
                             newFinish);
     if (newPart == NULL) return false;
 
-    City **failInsurance = oldRoute->howTheWayGoes;
-    oldRoute->howTheWayGoes = realloc(oldRoute->howTheWayGoes, sizeof(City *) *
-                                                               (oldRoute->length +
-                                                                newPart->length));
-    if (oldRoute->howTheWayGoes == NULL)
+    // the last city of the route starts the new part, hence the -1
+    if (!reserveRouteCities(oldRoute, oldRoute->length + newPart->length - 1) ||
+        !linkRouteSegments(oldRoute, newPart->roads, newPart->length - 1))
     {
-        oldRoute->howTheWayGoes = failInsurance;
-        free(newPart->howTheWayGoes);
-        free(newPart);
+        freeRoute(newPart);
         return false;
     }
 
@@ -272,131 +316,55 @@ bool extendRoute(Map *map, unsigned routeId, const char *city)
     {
         oldRoute->howTheWayGoes[oldLength-1 + i] = newPart->howTheWayGoes[i];
     }
+    for (unsigned i = 0; i + 1 < newPart->length; ++i)
+    {
+        oldRoute->roads[oldLength-1 + i] = newPart->roads[i];
+    }
+    indexRouteTail(oldRoute, oldLength);
+    forgetDescription(oldRoute);
 
-    free(newPart->howTheWayGoes);
-    free(newPart);
+    freeRoute(newPart);
     return true;
 }
 
 char const *getRouteDescription(Map *map, unsigned routeId)
 {
-    char* fail = malloc(sizeof(char)*1);
-    if (fail == NULL) return fail;
-    fail[0] = '\0';
+    Route *route = routeId < 1 ? NULL : lookupRoute(map->routes, routeId);
 
-    if (routeId >= ROUTES_AMOUNT || routeId < 1) return fail;
+    // no such route is described by an empty string
+    if (route == NULL) return calloc(1, sizeof(char));
 
-    if (map->routes[routeId] == NULL) return fail;
+    const char *description = cachedDescription(route);
+    if (description == NULL) return NULL;
 
-    char *returnedString = malloc(sizeof(char) * CHAR_BUFFER);
-    int neededLength = snprintf(NULL, 0, "%u;", routeId);
-    int actualLength = CHAR_BUFFER;
-
-    if (neededLength >= actualLength)
-    {
-        char *failInsurance = returnedString;
-        returnedString = realloc(returnedString, sizeof(char) * neededLength+1);
-        if (returnedString == NULL)
-        {
-            free(failInsurance);
-            return fail;
-        }
-    }
+    char *copy = malloc(sizeof(char) * (route->descriptionLength + 1));
+    if (copy == NULL) return NULL;
 
-    int lastChar = sprintf(returnedString, "%u;", routeId);
-    if (lastChar < 0)
-    {
-        free(returnedString);
-        return fail;
-    }
-
-    unsigned i = 0; // 'i' declared outside because will be needed later
-    for (; i < map->routes[routeId]->length - 1; ++i)
-    {
-        neededLength += snprintf(NULL, 0, "%s;",
-                                map->routes[routeId]->howTheWayGoes[i]->name);
-        if (neededLength >= actualLength)
-        {
-            char *failInsurance = returnedString;
-            returnedString = realloc(returnedString, sizeof(char) * neededLength+1);
-            if (returnedString == NULL)
-            {
-                free(failInsurance);
-                return fail;
-            }
-            actualLength = neededLength + 1;
-        }
-        int success = sprintf(returnedString + lastChar, "%s;",
-                              map->routes[routeId]->howTheWayGoes[i]->name);
-        if (success < 0)
-        {
-            free(returnedString);
-            return fail;
-        }
-        lastChar += success;
-
-        City *destination = map->routes[routeId]->howTheWayGoes[i + 1];
-        Road *road = findRoadBetween(map->routes[routeId]->howTheWayGoes[i],
-                                     destination);
-        neededLength += snprintf(NULL, 0, "%u;%d;", road->length,
-                                 road->year);
-        if (neededLength >= actualLength)
-        {
-            char *failInsurance = returnedString;
-            returnedString = realloc(returnedString, sizeof(char) * neededLength+1);
-            if (returnedString == NULL)
-            {
-                free(failInsurance);
-                return fail;
-            }
-            actualLength = neededLength + 1;
-        }
-        success = sprintf(returnedString + lastChar, "%u;%d;", road->length,
-                          road->year);
-        if (success < 0)
-        {
-            free(returnedString);
-            return fail;
-        }
-        lastChar += success;
-
-    }
-
-    // we do this outside of loop because we don`t want ';'
-    // nor want to overflow with howTheWayGoes[i + 1]
+    return memcpy(copy, description, route->descriptionLength + 1);
+}
 
-    neededLength += snprintf(NULL, 0, "%s",
-                             map->routes[routeId]->howTheWayGoes[i]->name);
-    if (neededLength >= actualLength)
-    {
-        char *failInsurance = returnedString;
-        returnedString = realloc(returnedString, sizeof(char) * neededLength+1);
-        if (returnedString == NULL)
-        {
-            free(failInsurance);
-            return fail;
-        }
-    }
+char const *peekRouteDescription(Map *map, unsigned routeId, size_t *length)
+{
+    Route *route = routeId < 1 ? NULL : lookupRoute(map->routes, routeId);
 
-    int success = sprintf(returnedString + lastChar, "%s",
-                          map->routes[routeId]->howTheWayGoes[i]->name);
-    if (success < 0)
+    if (route == NULL)
     {
-        free(returnedString);
-        return fail;
+        *length = 0;
+        return "";
     }
 
-    free(fail);
-    return returnedString;
+    const char *description = cachedDescription(route);
+    *length = route->descriptionLength;
+    return description;
 }
 
 Route* newCustomRoute(Map *map, unsigned routeId, const char *startCity)
 {
-    if (routeId < 1 || routeId >= ROUTES_AMOUNT)
+    if (routeId < 1)
     {
         return NULL;
     }
-    if (map->routes[routeId] != NULL)
+    if (lookupRoute(map->routes, routeId) != NULL)
     {
         return NULL;
     }
@@ -405,19 +373,35 @@ Route* newCustomRoute(Map *map, unsigned routeId, const char *startCity)
         return NULL;
     }
 
-    City *startCityPtr = findCity(map, startCity);
+    uint64_t startHash = hashKey(startCity);
+    City *startCityPtr = findCityHashed(map, startCity, startHash);
     if (startCityPtr == NULL)
     {
-        startCityPtr = makeNewCity(map, startCity);
+        startCityPtr = makeNewCity(map, startCity, startHash);
     }
 
     Route *newRoute = malloc(sizeof(Route));
     if (newRoute == NULL) return NULL;
 
+    newRoute->howTheWayGoes = NULL;
+    newRoute->roads = NULL;
+    newRoute->length = 0;
+    newRoute->capacity = 0;
+    newRoute->positions = NULL;
+    newRoute->description = NULL;
+    if (!reserveRouteCities(newRoute, 1))
+    {
+        freeRoute(newRoute);
+        return NULL;
+    }
     newRoute->length = 1;
-    newRoute->howTheWayGoes = malloc(sizeof(City*) * newRoute->length);
     newRoute->howTheWayGoes[0] = startCityPtr;
-    map->routes[routeId] = newRoute;
+    newRoute->id = routeId;
+    if (!registerRoute(map->routes, newRoute))
+    {
+        freeRoute(newRoute);
+        return NULL;
+    }
 
     return newRoute;
 }
@@ -428,16 +412,17 @@ bool extendCustomRoute(Map *map, unsigned routeId, unsigned length, int year,
     // if wrong arguments don`t waste time doing rest, routeId assumed correct
     if (length <= 0 || year == 0) return false;
 
-    City *start = map->routes[routeId]->howTheWayGoes[
-            map->routes[routeId]->length - 1];
-    City *destination = findCity(map, destinationName);
-    Road *road = (destination == NULL ? NULL : findRoadBetween(start,
+    Route *route = lookupRoute(map->routes, routeId);
+    City *start = route->howTheWayGoes[route->length - 1];
+    uint64_t destinationHash = hashKey(destinationName);
+    City *destination = findCityHashed(map, destinationName, destinationHash);
+    Road *road = (destination == NULL ? NULL : findRoadBetween(map, start,
                                                                destination));
     // if we don`t have a city, make one.
     if (destination == NULL)
     {
         if (!isCorrectName(destinationName)) return false;
-        destination = makeNewCity(map, destinationName);
+        destination = makeNewCity(map, destinationName, destinationHash);
     }
     // failed alloc
     if (destination == NULL) return false;
@@ -446,48 +431,49 @@ bool extendCustomRoute(Map *map, unsigned routeId, unsigned length, int year,
     if (road != NULL)
     {
         if (road->length != length || road->year > year) return false;
-        else road->year = year;
+        else setRoadYear(map, road, year);
     }
     else // if road == NULL, make one
     {
-        if (!makeNewRoad(start, destination, length, year)) return false;
+        if (!makeNewRoad(map, start, destination, length, year)) return false;
+        road = findRoadBetween(map, start, destination);
     }
 
     // now add new part to the route
-    map->routes[routeId]->length++;
-    City **failInsurance = map->routes[routeId]->howTheWayGoes;
+    if (!reserveRouteCities(route, route->length + 1)) return false;
+    route->length++;
 
-    map->routes[routeId]->howTheWayGoes = realloc(
-            map->routes[routeId]->howTheWayGoes,
-            sizeof(City *) * map->routes[routeId]->length);
-    if (map->routes[routeId]->howTheWayGoes == NULL)
+    route->howTheWayGoes[route->length - 1] = destination;
+    route->roads[route->length - 2] = road;
+    if (!linkRouteSegments(route, &road, 1))
     {
-        map->routes[routeId]->howTheWayGoes = failInsurance;
+        route->length--;
         return false;
     }
+    indexRouteTail(route, route->length - 1);
+    forgetDescription(route);
 
-    map->routes[routeId]->howTheWayGoes[map->routes[routeId]->length -
-                                        1] = destination;
     return true;
 }
 
 bool removeRoute(Map *map, unsigned routeId)
 {
-    if (routeId >= ROUTES_AMOUNT || routeId <= 0)
+    if (routeId <= 0)
     {
         return false;
     }
 
-    if (map->routes[routeId] == NULL)
+    Route *route = lookupRoute(map->routes, routeId);
+    if (route == NULL)
     {
         return false;
     }
 
     else
     {
-        free(map->routes[routeId]->howTheWayGoes);
-        free(map->routes[routeId]);
-        map->routes[routeId] = NULL;
+        unregisterRoute(map->routes, route);
+        unlinkRouteSegments(route, route->roads, route->length - 1);
+        freeRoute(route);
         return true;
     }
 }
\ No newline at end of file
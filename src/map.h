@@ -11,9 +11,15 @@
 
 #include <stdbool.h>
 #include <limits.h>
+#include <stdint.h>
+#include <stddef.h>
 #include "Dictionary.h"
-
-#define ROUTES_AMOUNT 1000
+#include "PriorityQueue.h"
+#include "RoadIndex.h"
+#include "StringArena.h"
+#include "ObjectPool.h"
+#include "RouteRegistry.h"
+#include "CityPositions.h"
 
 /**
    * Struktura przechowująca informacje o mieście.
@@ -21,14 +27,29 @@
 struct City
 {
     /**
-     * @brief Nazwa miasta.
+     * @brief Nazwa miasta, przechowywana w arenie nazw mapy.
+     */
+    const char *name;
+
+    /**
+     * @brief Numer miasta, nadawany kolejno od 0 przy jego tworzeniu
+     */
+    uint32_t id;
+
+    /**
+     * @brief Tablica odcinków drogowych incydentnych do tego miasta.
+     */
+    struct Road **roads;
+
+    /**
+     * @brief Liczba odcinków drogowych w tablicy roads.
      */
-    char *name;
+    unsigned roadsCount;
 
     /**
-     * @brief Lista łączona zawierająca odcinki drogowe incydentne do tego miasta.
+     * @brief Rozmiar zaalokowanej tablicy roads.
      */
-    struct RoadList *roads;
+    unsigned roadsCapacity;
 
     /**
      * @brief Najlepsza odległość, używane przez algorytm djkstry
@@ -49,6 +70,49 @@ struct City
     * @brief Najgorsza dotychczasowa wartość wieku, używana przez algorytm djkstry
     */
     int worstAge;
+
+    /**
+     * @brief Najlepsza odległość do miasta końcowego, używana przez
+     * dwukierunkowy algorytm djkstry
+     */
+    unsigned distanceBack;
+
+    /**
+     * @brief Flaga odwiedzenia przez wyszukiwanie od miasta końcowego
+     */
+    bool visitedBack;
+
+    /**
+     * @brief Flaga oznaczająca miasto leżące na którejś z najkrótszych dróg
+     * z miasta początkowego do końcowego
+     */
+    bool onShortestPath;
+
+    /**
+     * @brief Tablica odległości od kolejnych punktów orientacyjnych, lub NULL
+     * jeśli miasto powstało po ich wyznaczeniu. Odległości mogą przekraczać
+     * UINT_MAX.
+     */
+    unsigned long long *landmarkDistances;
+
+    /**
+     * @brief Ranga miasta w hierarchii kontrakcyjnej, lub NOT_RANKED jeśli
+     * miasto powstało po jej zbudowaniu
+     */
+    unsigned hierarchyRank;
+
+    /**
+    * @brief Pozycje miasta w kolejkach priorytetowych algorytmu djkstry
+    * (od początku i od końca), lub NOT_QUEUED jeśli go w nich nie ma
+    */
+    unsigned queueIndex[2];
+
+    /**
+    * @brief Numer wyszukiwania, które ostatnio ustawiło pola używane przez
+    * algorytm djkstry. Jeśli jest różny od numeru bieżącego wyszukiwania
+    * mapy, to pola te są nieaktualne
+    */
+    unsigned searchEpoch;
 };
 typedef struct City City;
 
@@ -78,28 +142,32 @@ struct Road
     int year;
 
     /**
-     * @brief Informacja, czy dany odcinek został już zakolejkowany do usunięcia
+     * @brief Pozycja odcinka w tablicy roads miasta cityA.
      */
-    bool queued;
-};
-typedef struct Road Road;
+    unsigned indexA;
 
-/**
- * Węzeł listy odcinków drogowych dla pojedynczego miasta.
- */
-struct RoadList
-{
     /**
-     * Wskazywany odcinek.
+     * @brief Pozycja odcinka w tablicy roads miasta cityB.
      */
-    struct Road *this;
+    unsigned indexB;
 
     /**
-     * Następny węzeł.
+     * @brief Drogi krajowe przechodzące przez ten odcinek; droga pojawia się
+     * tu tyle razy, ile razy przez niego przechodzi.
      */
-    struct RoadList *next;
+    struct Route **routes;
+
+    /**
+     * @brief Liczba elementów tablicy routes.
+     */
+    unsigned routesCount;
+
+    /**
+     * @brief Rozmiar zaalokowanej tablicy routes.
+     */
+    unsigned routesCapacity;
 };
-typedef struct RoadList RoadList;
+typedef struct Road Road;
 
 /**
  * @brief Struktura reprezentująca pojedynczą drogę krajową.
@@ -111,13 +179,89 @@ struct Route
     */
     struct City **howTheWayGoes;
 
+    /**
+     * @brief Tablica wskaźników na kolejne odcinki drogi krajowej; odcinek
+     * roads[i] łączy miasta howTheWayGoes[i] i howTheWayGoes[i + 1]
+     */
+    struct Road **roads;
+
     /**
      * @brief Informacja przez ile miast prowadzi droga krajowa
      */
     unsigned length;
+
+    /**
+     * @brief Rozmiar zaalokowanych tablic howTheWayGoes i roads
+     */
+    unsigned capacity;
+
+    /**
+     * @brief Numer drogi krajowej; ma znaczenie tylko dla dróg zarejestrowanych
+     * w mapie
+     */
+    unsigned id;
+
+    /**
+     * @brief Pozycja drogi na liście istniejących dróg rejestru
+     */
+    unsigned position;
+
+    /**
+     * @brief Indeks pozycji miast na drodze; tworzony przy pierwszym
+     * wyszukiwaniu, NULL jeśli jeszcze go nie ma
+     */
+    struct CityPositions *positions;
+
+    /**
+     * @brief Zapamiętany opis drogi krajowej, NULL jeśli trzeba go utworzyć
+     * od nowa; unieważniany przy zmianie przebiegu drogi lub roku jej odcinka
+     */
+    char *description;
+
+    /**
+     * @brief Długość zapamiętanego opisu, bez kończącego zera
+     */
+    size_t descriptionLength;
 };
 typedef struct Route Route;
 
+/**
+ * @brief Algorytm używany do wyznaczania dróg krajowych
+ * Wszystkie algorytmy dają te same wyniki. Długości dróg liczą bez
+ * przepełnienia, a drogi o długości co najmniej UINT_MAX traktują jak
+ * nieistniejące.
+ */
+enum SearchMode
+{
+    /**
+     * @brief Algorytm djkstry od miasta początkowego
+     */
+    SEARCH_DIJKSTRA,
+
+    /**
+     * @brief Dwukierunkowy algorytm djkstry, rozwijający jednocześnie
+     * wyszukiwanie od miasta początkowego i od miasta końcowego
+     */
+    SEARCH_BIDIRECTIONAL,
+
+    /**
+     * @brief Algorytm A* z punktami orientacyjnymi. Punkty są wyznaczane
+     * przed wyszukiwaniem w funkcjach newRoute i extendRoute, jeśli od ich
+     * poprzedniego wyznaczenia dodano odcinek drogi.
+     */
+    SEARCH_LANDMARKS,
+
+    /**
+     * @brief Wyszukiwanie w hierarchii kontrakcyjnej. Hierarchia jest
+     * budowana przed wyszukiwaniem w funkcji newRoute, jeśli od jej
+     * poprzedniej budowy dodano lub usunięto odcinek drogi. Funkcja
+     * extendRoute i objazdy w funkcji removeRoad, które muszą omijać miasta
+     * drogi krajowej, używają algorytmu djkstry.
+     */
+    SEARCH_CONTRACTION
+};
+typedef enum SearchMode SearchMode;
+
 /**
  * @brief Główna struktura zawierająca wskaźnik do listy miast i tablicy dróg krajowych.
  * Inicjalizację i usuwanie struktury realizują odpowiednio funkcje newMap() i deleteMap(Map *).
@@ -129,9 +273,99 @@ struct Map
      */
     struct Dictionary *cities;
     /**
-     * @brief Tablica zawierająca drogi krajowe
+     * @brief Tablica miast indeksowana ich numerami
+     */
+    struct City **cityById;
+    /**
+     * @brief Liczba miast, a zarazem numer następnego tworzonego miasta
+     */
+    uint32_t cityCount;
+    /**
+     * @brief Rozmiar zaalokowanej tablicy cityById
+     */
+    uint32_t cityByIdCapacity;
+    /**
+     * @brief Migawka sąsiedztwa miast używana przez wyszukiwanie dróg, lub NULL
+     * jeśli nie została jeszcze zbudowana
+     */
+    struct Adjacency *adjacency;
+    /**
+     * @brief Rejestr dróg krajowych, o numerach od 1 do UINT_MAX
+     */
+    struct RouteRegistry *routes;
+    /**
+     * @brief Indeks odcinków dróg według pary ich końców
+     */
+    struct RoadIndex *roadIndex;
+
+    /**
+     * @brief Arena przechowująca nazwy wszystkich miast
+     */
+    struct StringArena *names;
+
+    /**
+     * @brief Pula, z której przydzielane są miasta
+     */
+    struct ObjectPool *cityPool;
+
+    /**
+     * @brief Pula, z której przydzielane są odcinki dróg
+     */
+    struct ObjectPool *roadPool;
+    /**
+     * @brief Kolejka priorytetowa używana przez algorytm djkstry
+     */
+    struct PriorityQueue *queue;
+    /**
+     * @brief Kolejka priorytetowa wyszukiwania od miasta końcowego
      */
-    struct Route *routes[ROUTES_AMOUNT];
+    struct PriorityQueue *queueBack;
+    /**
+     * @brief Pomocnicza lista miast zbieranych przez wyszukiwanie, np. miast
+     * odwiedzonych od miasta końcowego w kolejności odwiedzenia
+     */
+    struct City **searchList;
+    /**
+     * @brief Liczba miast w tablicy searchList
+     */
+    unsigned searchListSize;
+    /**
+     * @brief Rozmiar zaalokowanej tablicy searchList
+     */
+    unsigned searchListCapacity;
+    /**
+     * @brief Algorytm używany do wyznaczania dróg krajowych
+     */
+    SearchMode searchMode;
+    /**
+     * @brief Licznik zmian sieci odcinków dróg, zwiększany przy dodaniu
+     * i usunięciu odcinka
+     */
+    unsigned long long graphVersion;
+    /**
+     * @brief Licznik dodanych odcinków dróg. Usunięcie odcinka i przywrócenie
+     * odcinka, którego nie udało się usunąć, go nie zmieniają.
+     */
+    unsigned long long roadAdditions;
+    /**
+     * @brief Punkty orientacyjne algorytmu A*, lub NULL jeśli nie zostały
+     * wyznaczone
+     */
+    struct Landmarks *landmarks;
+    /**
+     * @brief Hierarchia kontrakcyjna, lub NULL jeśli nie została zbudowana
+     */
+    struct Hierarchy *hierarchy;
+    /**
+     * @brief Numer bieżącego wyszukiwania drogi
+     */
+    unsigned searchEpoch;
+    /**
+     * @brief Indeks pozycji miast drogi krajowej, której bieżące wyszukiwanie
+     * nie może przecinać, lub NULL jeśli takiej drogi nie ma; zerowany przez
+     * startNewSearch(), więc ma znaczenie tylko w trakcie wyszukiwania
+     */
+    struct CityPositions *blockedCities;
 };
 typedef struct Map Map;
 
@@ -151,6 +385,45 @@ Map* newMap(void);
  */
 void deleteMap(Map *map);
 
+/** @brief Ustawia algorytm wyznaczania dróg krajowych.
+ * Zmienia algorytm używany przez funkcje @ref newRoute i @ref extendRoute
+ * oraz przy wyznaczaniu objazdów w funkcji @ref removeRoad. Wyznaczone drogi
+ * krajowe nie zależą od wybranego algorytmu. Program map wybiera algorytm
+ * opcją -s.
+ * @param[in,out] map    – wskaźnik na strukturę przechowującą mapę dróg;
+ * @param[in] mode       – wybrany algorytm.
+ */
+void setSearchMode(Map *map, SearchMode mode);
+
+/** @brief Wyznacza punkty orientacyjne dla wyszukiwania dróg krajowych.
+ * Wybiera podaną liczbę miast możliwie od siebie odległych i zapamiętuje
+ * odległości każdego miasta od każdego z nich. Dopóki nie zostanie dodany
+ * żaden odcinek drogi, funkcje wyznaczające drogi krajowe używają
+ * algorytmu A* z oszacowaniem odległości wynikającym z nierówności trójkąta,
+ * co znacznie zmniejsza liczbę odwiedzanych miast. Wyznaczone drogi krajowe
+ * nie zależą od tego, czy punkty orientacyjne są używane.
+ * @param[in,out] map    – wskaźnik na strukturę przechowującą mapę dróg;
+ * @param[in] count      – liczba punktów orientacyjnych; 0 usuwa punkty
+ *                         orientacyjne.
+ * @return Wartość @p true, jeśli punkty orientacyjne zostały wyznaczone lub
+ * usunięte. Wartość @p false, jeśli mapa nie zawiera żadnego miasta lub nie
+ * udało się zaalokować pamięci.
+ */
+bool prepareLandmarks(Map *map, unsigned count);
+
+/** @brief Buduje hierarchię kontrakcyjną dla wyszukiwania dróg krajowych.
+ * Kontraktuje kolejno wszystkie miasta, dodając skróty zastępujące najkrótsze
+ * drogi przez nie przechodzące. Dopóki nie zostanie dodany ani usunięty żaden
+ * odcinek drogi, funkcja @ref newRoute wyszukuje drogę w hierarchii, co
+ * przyspiesza wiele zapytań o drogi na niezmieniającej się mapie. Wyznaczone
+ * drogi krajowe nie zależą od tego, czy hierarchia jest używana.
+ * @param[in,out] map    – wskaźnik na strukturę przechowującą mapę dróg.
+ * @return Wartość @p true, jeśli hierarchia została zbudowana. Wartość
+ * @p false, jeśli mapa nie zawiera żadnego miasta lub nie udało się
+ * zaalokować pamięci.
+ */
+bool buildContractionHierarchy(Map *map);
+
 /** @brief Dodaje do mapy odcinek drogi między dwoma różnymi miastami.
  * Jeśli któreś z podanych miast nie istnieje, to dodaje go do mapy, a następnie
  * dodaje do mapy odcinek drogi między tymi miastami.
@@ -257,6 +530,17 @@ bool removeRoad(Map *map, const char *city1, const char *city2);
  */
 char const* getRouteDescription(Map *map, unsigned routeId);
 
+/** @brief Udostępnia informacje o drodze krajowej bez kopiowania.
+ * Działa jak @ref getRouteDescription, ale zwraca opis przechowywany w mapie,
+ * tworząc go tylko wtedy, gdy droga zmieniła się od poprzedniego wywołania.
+ * Napisu nie wolno zwalniać ani zmieniać; jest ważny do następnej zmiany mapy.
+ * @param[in,out] map    – wskaźnik na strukturę przechowującą mapę dróg;
+ * @param[in] routeId    – numer drogi krajowej;
+ * @param[out] length    – tu zapisywana jest długość napisu.
+ * @return Wskaźnik na napis lub NULL, gdy nie udało się zaalokować pamięci.
+ */
+char const* peekRouteDescription(Map *map, unsigned routeId, size_t *length);
+
 /** @brief Deklaruje nową drogę krajową o parametrach podanych przez użytkownika.
  * Tworzy drogę krajową, zaczynającą się w mieście o nazwie podanej przez użytkownika.
  * Jeżeli takie miasto nie istnieje, to tworzy je.
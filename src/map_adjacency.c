@@ -0,0 +1,302 @@
+/** @file
+ * Implementacja zwartej reprezentacji sąsiedztwa miast (CSR)
+ *
+ * @author Filip Bieńkowski 407686
+ * @copyright Uniwersytet Warszawski
+ */
+
+#include "map_adjacency.h"
+#include "map_operations.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief Najmniejsza liczba pozycji rezerwowana dla zakresu miasta
+ */
+#define MIN_RANGE_CAPACITY 4
+
+/**
+ * @brief Sprawdza, czy migawka odpowiada bieżącej sieci dróg. Może nie
+ * obejmować miast dodanych po jej budowie, które nie mają jeszcze odcinków.
+ * @param map -- wskaźnik na mapę
+ * @return Wartość @p true jeśli tak, wartość @p false w przeciwnym wypadku
+ */
+static inline bool adjacencyIsFresh(Map *map)
+{
+    return map->adjacency != NULL &&
+           map->adjacency->graphVersion == map->graphVersion;
+}
+
+/**
+ * @brief Powiększa tablice zakresów miast tak, by pomieściły podaną liczbę
+ * miast
+ * @param graph -- migawka
+ * @param cityCount -- liczba miast
+ * @return false, jeśli nie udało się zaalokować pamięci; w przeciwnym wypadku true
+ */
+static bool reserveCities(Adjacency *graph, uint32_t cityCount)
+{
+    if (cityCount <= graph->offsetsCapacity) return true;
+
+    uint32_t capacity = 2 * graph->offsetsCapacity;
+    if (capacity < cityCount) capacity = cityCount;
+
+    uint32_t *offsets = realloc(graph->offsets, sizeof(uint32_t) * capacity);
+    if (offsets == NULL) return false;
+    graph->offsets = offsets;
+
+    uint32_t *ends = realloc(graph->ends, sizeof(uint32_t) * capacity);
+    if (ends == NULL) return false;
+    graph->ends = ends;
+
+    uint32_t *limits = realloc(graph->limits, sizeof(uint32_t) * capacity);
+    if (limits == NULL) return false;
+    graph->limits = limits;
+
+    graph->offsetsCapacity = capacity;
+    return true;
+}
+
+/**
+ * @brief Powiększa tablice odcinków migawki tak, by pomieściły podaną liczbę
+ * pozycji
+ * @param graph -- migawka
+ * @param edgesCount -- liczba pozycji
+ * @return false, jeśli nie udało się zaalokować pamięci; w przeciwnym wypadku true
+ */
+static bool reserveEdges(Adjacency *graph, uint32_t edgesCount)
+{
+    if (edgesCount <= graph->edgesCapacity) return true;
+
+    // doubling keeps the moves of ranges to the end amortised constant
+    uint32_t capacity = 2 * graph->edgesCapacity;
+    if (capacity < edgesCount) capacity = edgesCount;
+
+    uint32_t *neighbours = realloc(graph->neighbours,
+                                   sizeof(uint32_t) * capacity);
+    if (neighbours == NULL) return false;
+    graph->neighbours = neighbours;
+
+    unsigned *lengths = realloc(graph->lengths, sizeof(unsigned) * capacity);
+    if (lengths == NULL) return false;
+    graph->lengths = lengths;
+
+    int *years = realloc(graph->years, sizeof(int) * capacity);
+    if (years == NULL) return false;
+    graph->years = years;
+
+    graph->edgesCapacity = capacity;
+    return true;
+}
+
+/**
+ * @brief Dodaje do migawki puste zakresy miast dodanych po jej budowie
+ * @param graph -- migawka
+ * @param cityCount -- liczba miast mapy
+ * @return false, jeśli nie udało się zaalokować pamięci; w przeciwnym wypadku true
+ */
+static bool coverCities(Adjacency *graph, uint32_t cityCount)
+{
+    if (!reserveCities(graph, cityCount)) return false;
+
+    for (uint32_t id = graph->cityCount; id < cityCount; ++id)
+    {
+        graph->offsets[id] = graph->edgesEnd;
+        graph->ends[id] = graph->edgesEnd;
+        graph->limits[id] = graph->edgesEnd;
+    }
+    graph->cityCount = cityCount;
+
+    return true;
+}
+
+/**
+ * @brief Buduje migawkę od nowa, bez wolnych pozycji między zakresami
+ * @param map -- wskaźnik na mapę
+ * @return false, jeśli nie udało się zaalokować pamięci; w przeciwnym wypadku true
+ */
+static bool rebuildAdjacency(Map *map)
+{
+    Adjacency *graph = map->adjacency;
+
+    uint32_t edgesCount = 0;
+    for (uint32_t id = 0; id < map->cityCount; ++id)
+    {
+        edgesCount += map->cityById[id]->roadsCount;
+    }
+
+    // on failure the version is left unchanged, so the snapshot stays stale
+    if (!reserveCities(graph, map->cityCount) ||
+        !reserveEdges(graph, edgesCount))
+    {
+        return false;
+    }
+
+    uint32_t position = 0;
+    for (uint32_t id = 0; id < map->cityCount; ++id)
+    {
+        City *city = map->cityById[id];
+        graph->offsets[id] = position;
+
+        for (unsigned i = 0; i < city->roadsCount; ++i, ++position)
+        {
+            Road *road = city->roads[i];
+            City *neighbour = road->cityA == city ? road->cityB : road->cityA;
+            graph->neighbours[position] = neighbour->id;
+            graph->lengths[position] = road->length;
+            graph->years[position] = road->year;
+        }
+
+        graph->ends[id] = position;
+        graph->limits[id] = position;
+    }
+
+    graph->cityCount = map->cityCount;
+    graph->edgesEnd = position;
+    graph->edgesCount = position;
+    graph->wastedEdges = 0;
+    graph->graphVersion = map->graphVersion;
+    return true;
+}
+
+bool refreshAdjacency(Map *map)
+{
+    Adjacency *graph = map->adjacency;
+
+    if (adjacencyIsFresh(map) && graph->wastedEdges <= graph->edgesCount)
+    {
+        return coverCities(graph, map->cityCount);
+    }
+
+    if (graph == NULL)
+    {
+        map->adjacency = calloc(1, sizeof(Adjacency));
+        if (map->adjacency == NULL) return false;
+    }
+
+    return rebuildAdjacency(map);
+}
+
+/**
+ * @brief Zapewnia wolną pozycję na końcu zakresu miasta, w razie potrzeby
+ * przenosząc zakres na koniec tablic
+ * @param graph -- migawka
+ * @param id -- numer miasta
+ * @return false, jeśli nie udało się zaalokować pamięci; w przeciwnym wypadku true
+ */
+static bool makeRoomInRange(Adjacency *graph, uint32_t id)
+{
+    if (graph->ends[id] < graph->limits[id]) return true;
+
+    uint32_t used = graph->ends[id] - graph->offsets[id];
+    uint32_t capacity = 2 * used;
+    if (capacity < MIN_RANGE_CAPACITY) capacity = MIN_RANGE_CAPACITY;
+
+    // the last range grows where it is, the others move to the end
+    if (graph->limits[id] == graph->edgesEnd)
+    {
+        uint32_t limit = graph->offsets[id] + capacity;
+        if (!reserveEdges(graph, limit)) return false;
+        graph->limits[id] = limit;
+        graph->edgesEnd = limit;
+        return true;
+    }
+
+    uint32_t offset = graph->edgesEnd;
+    if (!reserveEdges(graph, offset + capacity)) return false;
+
+    uint32_t from = graph->offsets[id];
+    memcpy(graph->neighbours + offset, graph->neighbours + from,
+           sizeof(uint32_t) * used);
+    memcpy(graph->lengths + offset, graph->lengths + from,
+           sizeof(unsigned) * used);
+    memcpy(graph->years + offset, graph->years + from, sizeof(int) * used);
+
+    graph->wastedEdges += graph->limits[id] - from;
+    graph->offsets[id] = offset;
+    graph->ends[id] = offset + used;
+    graph->limits[id] = offset + capacity;
+    graph->edgesEnd = offset + capacity;
+    return true;
+}
+
+void appendEdge(Map *map, City *city)
+{
+    if (!adjacencyIsFresh(map)) return;
+    Adjacency *graph = map->adjacency;
+
+    if (!coverCities(graph, map->cityCount) ||
+        !makeRoomInRange(graph, city->id))
+    {
+        removeAdjacency(map);
+        return;
+    }
+
+    Road *road = city->roads[city->roadsCount - 1];
+    City *neighbour = road->cityA == city ? road->cityB : road->cityA;
+    uint32_t position = graph->ends[city->id]++;
+
+    graph->neighbours[position] = neighbour->id;
+    graph->lengths[position] = road->length;
+    graph->years[position] = road->year;
+    graph->edgesCount++;
+}
+
+void removeEdgeAt(Map *map, City *city, unsigned index)
+{
+    if (!adjacencyIsFresh(map)) return;
+    Adjacency *graph = map->adjacency;
+
+    uint32_t position = graph->offsets[city->id] + index;
+    uint32_t last = --graph->ends[city->id];
+
+    graph->neighbours[position] = graph->neighbours[last];
+    graph->lengths[position] = graph->lengths[last];
+    graph->years[position] = graph->years[last];
+    graph->edgesCount--;
+}
+
+void graphChanged(Map *map)
+{
+    bool fresh = adjacencyIsFresh(map);
+
+    map->graphVersion++;
+    if (fresh) map->adjacency->graphVersion = map->graphVersion;
+}
+
+void setRoadYear(Map *map, Road *road, int year)
+{
+    if (road->year == year) return;
+    road->year = year;
+
+    // descriptions of routes through the road show its year
+    for (unsigned i = 0; i < road->routesCount; ++i)
+    {
+        forgetDescription(road->routes[i]);
+    }
+
+    // a stale snapshot copies years again when it is rebuilt; a fresh one
+    // keeps the order of the arrays of roads of the cities, so both entries,
+    // also of a road from a city to itself, are found directly
+    if (adjacencyIsFresh(map))
+    {
+        Adjacency *graph = map->adjacency;
+        graph->years[graph->offsets[road->cityA->id] + road->indexA] = year;
+        graph->years[graph->offsets[road->cityB->id] + road->indexB] = year;
+    }
+}
+
+void removeAdjacency(Map *map)
+{
+    if (map->adjacency == NULL) return;
+
+    free(map->adjacency->offsets);
+    free(map->adjacency->ends);
+    free(map->adjacency->limits);
+    free(map->adjacency->neighbours);
+    free(map->adjacency->lengths);
+    free(map->adjacency->years);
+    free(map->adjacency);
+    map->adjacency = NULL;
+}
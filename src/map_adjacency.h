@@ -0,0 +1,145 @@
+/** @file
+ * Interfejs zwartej reprezentacji sąsiedztwa miast (CSR)
+ *
+ * @author Filip Bieńkowski 407686
+ * @copyright Uniwersytet Warszawski
+ */
+
+#ifndef DROGI_MAP_ADJACENCY_H
+#define DROGI_MAP_ADJACENCY_H
+
+#include "map.h"
+
+/**
+ * @brief Migawka sieci dróg w postaci tablic ciągłych
+ * Odcinki wychodzące z miasta o numerze i zajmują pozycje od offsets[i] do
+ * ends[i] - 1 równoległych tablic neighbours, lengths i years, w tej samej
+ * kolejności co w tablicy odcinków miasta, więc algorytmy wyszukiwania
+ * przeglądają sąsiadów bez chodzenia po listach. Dodanie i usunięcie odcinka
+ * poprawia migawkę w miejscu; zakres miasta, w którym zabrakło miejsca, jest
+ * przenoszony na koniec tablic, a migawka jest budowana od nowa dopiero wtedy,
+ * gdy porzucone w ten sposób pozycje przewyższą liczbą używane.
+ */
+struct Adjacency
+{
+    /**
+     * @brief Liczba miast objętych migawką
+     */
+    uint32_t cityCount;
+
+    /**
+     * @brief Początki zakresów sąsiadów kolejnych miast
+     */
+    uint32_t *offsets;
+
+    /**
+     * @brief Końce zakresów sąsiadów kolejnych miast
+     */
+    uint32_t *ends;
+
+    /**
+     * @brief Końce miejsca zarezerwowanego dla zakresów kolejnych miast
+     */
+    uint32_t *limits;
+
+    /**
+     * @brief Numery sąsiednich miast
+     */
+    uint32_t *neighbours;
+
+    /**
+     * @brief Długości odcinków do sąsiadów
+     */
+    unsigned *lengths;
+
+    /**
+     * @brief Lata budowy lub ostatniego remontu odcinków do sąsiadów
+     */
+    int *years;
+
+    /**
+     * @brief Rozmiar zaalokowanych tablic offsets, ends i limits
+     */
+    uint32_t offsetsCapacity;
+
+    /**
+     * @brief Rozmiar zaalokowanych tablic neighbours, lengths i years
+     */
+    uint32_t edgesCapacity;
+
+    /**
+     * @brief Pierwsza pozycja tablic neighbours, lengths i years, której nie
+     * zajmuje zakres żadnego miasta
+     */
+    uint32_t edgesEnd;
+
+    /**
+     * @brief Liczba używanych pozycji, czyli odcinków liczonych z obu końców
+     */
+    uint32_t edgesCount;
+
+    /**
+     * @brief Liczba pozycji porzuconych przy przenoszeniu zakresów miast
+     */
+    uint32_t wastedEdges;
+
+    /**
+     * @brief Wartość licznika zmian sieci dróg, której odpowiada migawka
+     */
+    unsigned long long graphVersion;
+};
+typedef struct Adjacency Adjacency;
+
+/**
+ * @brief Zapewnia aktualność migawki sąsiedztwa
+ * Migawka jest budowana od nowa, jeśli nie została poprawiona po zmianie sieci
+ * dróg albo zawiera zbyt wiele porzuconych pozycji. Nowe miasta dostają puste
+ * zakresy sąsiadów.
+ * @param map -- wskaźnik na mapę
+ * @return false, jeśli nie udało się zaalokować pamięci; w przeciwnym wypadku true
+ */
+bool refreshAdjacency(Map *map);
+
+/**
+ * @brief Dopisuje do aktualnej migawki ostatni odcinek z tablicy odcinków
+ * miasta. Wywoływana po dopisaniu odcinka do tej tablicy. Jeśli nie uda się
+ * zaalokować pamięci, migawka jest usuwana i zostanie zbudowana od nowa przy
+ * najbliższym wyszukiwaniu.
+ * @param map -- wskaźnik na mapę
+ * @param city -- miasto
+ */
+void appendEdge(Map *map, City *city);
+
+/**
+ * @brief Usuwa z aktualnej migawki odcinek miasta z podanej pozycji, tak jak
+ * z tablicy odcinków miasta: na jego miejsce trafia ostatni odcinek zakresu
+ * @param map -- wskaźnik na mapę
+ * @param city -- miasto
+ * @param index -- pozycja usuwanego odcinka w tablicy odcinków miasta
+ */
+void removeEdgeAt(Map *map, City *city, unsigned index);
+
+/**
+ * @brief Odnotowuje zmianę sieci dróg. Migawka, która była aktualna, została
+ * już poprawiona, więc pozostaje aktualna.
+ * @param map -- wskaźnik na mapę
+ */
+void graphChanged(Map *map);
+
+/**
+ * @brief Zmienia rok budowy lub ostatniego remontu odcinka drogi,
+ * uaktualniając również aktualną migawkę sąsiedztwa i unieważniając opisy
+ * dróg krajowych, które przez niego przechodzą
+ * @param map -- wskaźnik na mapę
+ * @param road -- odcinek drogi
+ * @param year -- nowy rok
+ */
+void setRoadYear(Map *map, Road *road, int year);
+
+/**
+ * @brief Usuwa migawkę sąsiedztwa
+ * @param map -- wskaźnik na mapę
+ */
+void removeAdjacency(Map *map);
+
+#endif //DROGI_MAP_ADJACENCY_H
@@ -0,0 +1,227 @@
+/** @file
+ * Implementacja dwukierunkowego algorytmu djkstry
+ *
+ * @author Filip Bieńkowski 407686
+ * @copyright Uniwersytet Warszawski
+ */
+
+#include "map_bidirectional.h"
+#include "map_operations.h"
+#include "map_adjacency.h"
+
+#include <stdlib.h>
+
+#define NO_MEETING ULLONG_MAX
+
+static inline int min(int arg1, int arg2)
+{
+    return arg1 < arg2 ? arg1 : arg2;
+}
+
+/**
+ * @brief Poprawia długość najkrótszej znanej drogi przechodzącej przez miasto
+ * Drogi o długości co najmniej INFINITY są pomijane, tak jak w relaxRoad.
+ * @param best -- długość najkrótszej znanej drogi
+ * @param forward -- odległość miasta od początku
+ * @param backward -- odległość miasta od końca
+ */
+static inline void updateMeeting(unsigned long long *best, unsigned forward,
+                                 unsigned backward)
+{
+    if (forward != INFINITY && backward != INFINITY)
+    {
+        unsigned long long length = (unsigned long long) forward + backward;
+        if (length < INFINITY && length < *best) *best = length;
+    }
+}
+
+/**
+ * @brief Odwiedza najbliższe miasto wyszukiwania od początku
+ * @param map -- wskaźnik na mapę
+ * @param best -- długość najkrótszej znanej drogi, poprawiana przy spotkaniu
+ * @return false, jeśli nie udało się zaalokować pamięci; w przeciwnym wypadku true
+ */
+static bool settleForward(Map *map, unsigned long long *best)
+{
+    Adjacency *graph = map->adjacency;
+    City *actCity = popMin(map->queue);
+    actCity->visited = true;
+    updateMeeting(best, actCity->distance, actCity->distanceBack);
+
+    for (uint32_t i = graph->offsets[actCity->id];
+         i < graph->ends[actCity->id]; ++i)
+    {
+        City *neighbour = map->cityById[graph->neighbours[i]];
+        touchCity(map, neighbour);
+
+        if (!neighbour->visited)
+        {
+            if (!relaxRoad(map, actCity, neighbour, graph->lengths[i],
+                           graph->years[i]))
+            {
+                return false;
+            }
+            updateMeeting(best, addLength(actCity->distance,
+                                          graph->lengths[i]),
+                          neighbour->distanceBack);
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Odwiedza najbliższe miasto wyszukiwania od końca
+ * Wyszukiwanie od końca wyznacza tylko odległości; wiek i poprzednicy są
+ * ustalani później przez labelBackwardPart.
+ * @param map -- wskaźnik na mapę
+ * @param best -- długość najkrótszej znanej drogi, poprawiana przy spotkaniu
+ * @return false, jeśli nie udało się zaalokować pamięci; w przeciwnym wypadku true
+ */
+static bool settleBackward(Map *map, unsigned long long *best)
+{
+    Adjacency *graph = map->adjacency;
+    City *actCity = popMin(map->queueBack);
+    actCity->visitedBack = true;
+    if (!appendToSearchList(map, actCity)) return false;
+    updateMeeting(best, actCity->distance, actCity->distanceBack);
+
+    for (uint32_t i = graph->offsets[actCity->id];
+         i < graph->ends[actCity->id]; ++i)
+    {
+        City *neighbour = map->cityById[graph->neighbours[i]];
+        touchCity(map, neighbour);
+
+        if (!neighbour->visitedBack)
+        {
+            unsigned newDistance = addLength(actCity->distanceBack,
+                                             graph->lengths[i]);
+            if (newDistance == INFINITY) continue; // too long, so no such path
+
+            if (newDistance < neighbour->distanceBack)
+            {
+                neighbour->distanceBack = newDistance;
+                if (!pushOrDecrease(map->queueBack, neighbour, newDistance))
+                {
+                    return false;
+                }
+            }
+            updateMeeting(best, neighbour->distance, newDistance);
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Ustala odległość od początku, najgorszy wiek i poprzednika miast
+ * najkrótszych dróg, które odwiedziło tylko wyszukiwanie od końca.
+ * Miasta są przetwarzane od najdalszego od końca, czyli w kolejności rosnącej
+ * odległości od początku. Poprzednikami miasta są te sąsiednie miasta
+ * o ustalonej odległości od początku, przez które prowadzi do niego
+ * najkrótsza droga - tak jak w zwykłym algorytmie djkstry, więc wybór
+ * poprzednika i niejednoznaczność są takie same.
+ * @param map -- wskaźnik na mapę
+ * @param best -- długość najkrótszej drogi z początku do końca
+ */
+static void labelBackwardPart(Map *map, unsigned long long best)
+{
+    Adjacency *graph = map->adjacency;
+
+    for (unsigned i = map->searchListSize; i-- > 0;)
+    {
+        City *city = map->searchList[i];
+
+        // cities visited from the start already have final labels
+        if (city->visited || city->distanceBack > best) continue;
+
+        unsigned long long distance = best - city->distanceBack;
+        bool reached = false;
+        int bestAge = YEAR_INFINTY;
+        City *bestPrevious = NULL;
+
+        for (uint32_t j = graph->offsets[city->id];
+             j < graph->ends[city->id]; ++j)
+        {
+            City *neighbour = map->cityById[graph->neighbours[j]];
+            touchCity(map, neighbour);
+
+            if (!neighbour->visited || neighbour->distance == INFINITY ||
+                (unsigned long long) neighbour->distance +
+                graph->lengths[j] != distance)
+            {
+                continue;
+            }
+
+            int newAge = min(neighbour->worstAge, graph->years[j]);
+            if (!reached || newAge > bestAge)
+            {
+                reached = true;
+                bestAge = newAge;
+                bestPrevious = neighbour;
+            }
+            else if (newAge == bestAge)
+            {
+                // same rule as in relaxRoad: no unique way to this node
+                bestPrevious = NULL;
+            }
+        }
+
+        // no shortest path from the start goes through this city
+        if (!reached) continue;
+
+        city->distance = distance;
+        city->worstAge = bestAge;
+        city->previous = bestPrevious;
+        city->visited = true;
+    }
+}
+
+Route *bidirectionalDkstra(Map *map, unsigned routeId, City *start,
+                           City *finish)
+{
+    if (!refreshAdjacency(map)) return NULL;
+
+    startNewSearch(map);
+    blockRouteCities(map, routeId);
+    map->searchListSize = 0;
+
+    touchCity(map, start);
+    touchCity(map, finish);
+    start->distance = 0;
+    start->visited = false;
+    start->visitedBack = false;
+    finish->distanceBack = 0;
+    finish->visited = false;
+    finish->visitedBack = false;
+
+    if (!pushOrDecrease(map->queue, start, start->distance) ||
+        !pushOrDecrease(map->queueBack, finish, finish->distanceBack))
+    {
+        return NULL;
+    }
+
+    unsigned long long best = NO_MEETING;
+
+    while (!isQueueEmpty(map->queue) && !isQueueEmpty(map->queueBack))
+    {
+        unsigned long long topForward = minKey(map->queue);
+        unsigned long long topBackward = minKey(map->queueBack);
+
+        // we stop only when the frontiers are strictly further apart than the
+        // best path, so each city on every shortest path is settled by at
+        // least one of the searches and ties can be detected
+        if (topForward + topBackward > best) break;
+
+        bool success = topForward <= topBackward ? settleForward(map, &best)
+                                                 : settleBackward(map, &best);
+        if (!success) return NULL;
+    }
+
+    // frontiers never met, so there is no path from start to finish
+    if (best == NO_MEETING) return NULL;
+
+    labelBackwardPart(map, best);
+
+    return routeFromPrevious(map, start, finish);
+}
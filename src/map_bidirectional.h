@@ -0,0 +1,29 @@
+/** @file
+ * Interfejs dwukierunkowego algorytmu djkstry
+ *
+ * @author Filip Bieńkowski 407686
+ * @copyright Uniwersytet Warszawski
+ */
+
+#ifndef DROGI_MAP_BIDIRECTIONAL_H
+#define DROGI_MAP_BIDIRECTIONAL_H
+
+#include "map.h"
+
+/**
+ * @brief Dwukierunkowa implementacja algorytmu djkstry
+ * Znajduje najkrótszą drogę z miasta 'start' do miasta 'finish', rozwijając
+ * naprzemiennie wyszukiwanie od obu końców. Po wyznaczeniu długości
+ * najkrótszej drogi uzupełnia najgorszy wiek i poprzedników miast odwiedzonych
+ * tylko od końca, dzięki czemu wynik (również niejednoznaczność) jest taki sam
+ * jak dla funkcji dkstra.
+ * @param map -- wskaźnik na mapę
+ * @param routeId -- numer drogi krajowej
+ * @param start -- miasto początkowe
+ * @param finish -- miasto końcowe
+ * @return Potencjalna droga krajowa, albo NULL jeśli nie ma drogi z A do B
+ */
+Route *bidirectionalDkstra(Map *map, unsigned routeId, City *start,
+                           City *finish);
+
+#endif //DROGI_MAP_BIDIRECTIONAL_H
@@ -0,0 +1,1082 @@
+/** @file
+ * Implementacja hierarchii kontrakcyjnej mapy dróg
+ *
+ * Miasta są kolejno usuwane (kontraktowane) z grafu, a najkrótsze drogi
+ * przez usuwane miasto są zastępowane skrótami między jego sąsiadami.
+ * Skrót jest dodawany również wtedy, gdy istnieje inna, tak samo długa droga,
+ * dzięki czemu hierarchia reprezentuje wszystkie najkrótsze drogi, a nie
+ * tylko jedną z nich - jest to potrzebne do wykrywania niejednoznaczności.
+ *
+ * @author Filip Bieńkowski 407686
+ * @copyright Uniwersytet Warszawski
+ */
+
+#include "map_contraction.h"
+#include "map_operations.h"
+#include "map_adjacency.h"
+
+#include <stdlib.h>
+
+/**
+ * @brief Maksymalna liczba miast odwiedzanych przy szukaniu drogi omijającej
+ * kontraktowane miasto. Gdy jej nie znajdziemy, dodajemy zbędny, ale
+ * poprawny skrót.
+ */
+#define WITNESS_SETTLE_LIMIT 100
+#define NO_DISTANCE ULLONG_MAX
+
+/**
+ * @brief Krawędź grafu hierarchii: odcinek drogi lub skrót
+ */
+struct HierarchyEdge
+{
+    /**
+     * @brief Numer miasta na drugim końcu krawędzi
+     */
+    unsigned target;
+
+    /**
+     * @brief Numer krawędzi skierowanej w górę hierarchii, którą jest ta
+     * krawędź lub do której jest przeciwna
+     */
+    unsigned id;
+
+    /**
+     * @brief Długość krawędzi
+     */
+    unsigned long long length;
+};
+typedef struct HierarchyEdge HierarchyEdge;
+
+/**
+ * @brief Rosnąca lista krawędzi jednego miasta
+ */
+struct EdgeList
+{
+    HierarchyEdge *edges; ///< tablica krawędzi
+    unsigned size; ///< liczba krawędzi
+    unsigned capacity; ///< rozmiar zaalokowanej tablicy
+};
+typedef struct EdgeList EdgeList;
+
+/**
+ * @brief Element kopca: numer miasta z kluczem
+ */
+struct HeapItem
+{
+    long long key; ///< klucz
+    unsigned node; ///< numer miasta
+};
+typedef struct HeapItem HeapItem;
+
+/**
+ * @brief Kopiec binarny bez zmniejszania klucza; nieaktualne elementy są
+ * pomijane przy wyjmowaniu
+ */
+struct LazyHeap
+{
+    HeapItem *items; ///< tablica elementów
+    unsigned size; ///< liczba elementów
+    unsigned capacity; ///< rozmiar zaalokowanej tablicy
+};
+typedef struct LazyHeap LazyHeap;
+
+/**
+ * @brief Krawędź hierarchii leżąca na najkrótszej drodze, do rozwinięcia
+ */
+struct Segment
+{
+    unsigned from; ///< miasto bliższe początku drogi
+    unsigned to; ///< miasto dalsze od początku drogi
+    unsigned id; ///< numer krawędzi
+    unsigned long long length; ///< długość krawędzi
+    unsigned long long offset; ///< odległość miasta 'from' od początku drogi
+};
+typedef struct Segment Segment;
+
+/**
+ * @brief Hierarchia kontrakcyjna. Miasta są numerowane kolejnością kontrakcji
+ * (rangą); krawędzie w górę i w dół są przechowywane w tablicach ciągłych
+ * z przesunięciami dla kolejnych miast.
+ */
+struct Hierarchy
+{
+    unsigned count; ///< liczba miast
+    City **cities; ///< miasta według rangi
+    unsigned *upOffsets; ///< początki list krawędzi w górę
+    HierarchyEdge *upEdges; ///< krawędzie do miast o wyższej randze
+    unsigned *downOffsets; ///< początki list krawędzi w dół
+    HierarchyEdge *downEdges; ///< krawędzie do miast o niższej randze
+    unsigned long long graphVersion; ///< wersja sieci dróg w chwili budowy
+
+    unsigned long long *distance[2]; ///< odległości w obu wyszukiwaniach
+    unsigned *stamp[2]; ///< numer zapytania, które ustawiło odległość
+    unsigned *mark[2]; ///< numer zapytania, które dodało miasto do listy
+    unsigned *edgeStamp; ///< numer zapytania, które rozwinęło krawędź
+    unsigned queryStamp; ///< numer bieżącego zapytania
+    LazyHeap heap[2]; ///< kopce obu wyszukiwań
+    unsigned *list; ///< pomocnicza lista miast
+    unsigned listSize; ///< liczba miast na liście
+    unsigned listCapacity; ///< rozmiar zaalokowanej listy
+    Segment *segments; ///< stos krawędzi do rozwinięcia
+    unsigned segmentsSize; ///< liczba krawędzi na stosie
+    unsigned segmentsCapacity; ///< rozmiar zaalokowanego stosu
+};
+
+/**
+ * @brief Stan budowy hierarchii; miasta są numerowane tak jak w mapie
+ */
+struct Builder
+{
+    unsigned count; ///< liczba miast
+    City **cities; ///< miasta
+    EdgeList *working; ///< graf miast jeszcze nie skontraktowanych
+    EdgeList *upward; ///< krawędzie do miast skontraktowanych później
+    bool *contracted; ///< czy miasto jest już skontraktowane
+    unsigned *contractedNeighbours; ///< liczba skontraktowanych sąsiadów
+    unsigned *rank; ///< ranga skontraktowanego miasta
+    unsigned long long *distance; ///< odległości w wyszukiwaniu świadka
+    unsigned *stamp; ///< numer wyszukiwania, które ustawiło odległość
+    unsigned *targetStamp; ///< numer wyszukiwania, dla którego miasto jest celem
+    unsigned currentStamp; ///< numer bieżącego wyszukiwania świadka
+    LazyHeap heap; ///< kopiec wyszukiwania świadka
+    bool failed; ///< czy zabrakło pamięci
+};
+typedef struct Builder Builder;
+
+/**
+ * @brief Zapewnia miejsce w rosnącej tablicy
+ * @param array -- tablica
+ * @param capacity -- rozmiar tablicy, aktualizowany po powiększeniu
+ * @param needed -- potrzebna liczba elementów
+ * @param size -- rozmiar elementu
+ * @return Tablica (być może przeniesiona) lub NULL, jeśli zabrakło pamięci
+ */
+static void *reserve(void *array, unsigned *capacity, unsigned needed,
+                     size_t size)
+{
+    if (needed <= *capacity) return array;
+
+    unsigned newCapacity = *capacity < 16 ? 16 : *capacity;
+    while (newCapacity < needed) newCapacity *= 2;
+
+    void *newArray = realloc(array, size * newCapacity);
+    if (newArray == NULL) return NULL;
+
+    *capacity = newCapacity;
+    return newArray;
+}
+
+/**
+ * @brief Wkłada element do kopca
+ * @param heap -- kopiec
+ * @param key -- klucz
+ * @param node -- numer miasta
+ * @return false, jeśli nie udało się zaalokować pamięci; w przeciwnym wypadku true
+ */
+static bool heapPush(LazyHeap *heap, long long key, unsigned node)
+{
+    HeapItem *items = reserve(heap->items, &heap->capacity, heap->size + 1,
+                              sizeof(HeapItem));
+    if (items == NULL) return false;
+    heap->items = items;
+
+    unsigned position = heap->size++;
+    while (position > 0)
+    {
+        unsigned parent = (position - 1) / 2;
+        if (items[parent].key <= key) break;
+        items[position] = items[parent];
+        position = parent;
+    }
+
+    items[position].key = key;
+    items[position].node = node;
+    return true;
+}
+
+/**
+ * @brief Wyjmuje z niepustego kopca element o najmniejszym kluczu
+ * @param heap -- kopiec
+ * @return Wyjęty element
+ */
+static HeapItem heapPop(LazyHeap *heap)
+{
+    HeapItem *items = heap->items;
+    HeapItem top = items[0];
+    HeapItem moved = items[--heap->size];
+
+    unsigned position = 0;
+    while (true)
+    {
+        unsigned child = 2 * position + 1;
+        if (child >= heap->size) break;
+        if (child + 1 < heap->size && items[child + 1].key < items[child].key)
+        {
+            ++child;
+        }
+        if (moved.key <= items[child].key) break;
+        items[position] = items[child];
+        position = child;
+    }
+
+    if (heap->size > 0) items[position] = moved;
+    return top;
+}
+
+/**
+ * @brief Dodaje krawędź do listy lub skraca istniejącą krawędź do tego miasta
+ * @param list -- lista krawędzi
+ * @param target -- drugi koniec krawędzi
+ * @param length -- długość krawędzi
+ * @return false, jeśli nie udało się zaalokować pamięci; w przeciwnym wypadku true
+ */
+static bool addOrShorten(EdgeList *list, unsigned target,
+                         unsigned long long length)
+{
+    for (unsigned i = 0; i < list->size; ++i)
+    {
+        if (list->edges[i].target == target)
+        {
+            if (length < list->edges[i].length) list->edges[i].length = length;
+            return true;
+        }
+    }
+
+    HierarchyEdge *edges = reserve(list->edges, &list->capacity,
+                                   list->size + 1, sizeof(HierarchyEdge));
+    if (edges == NULL) return false;
+    list->edges = edges;
+
+    list->edges[list->size].target = target;
+    list->edges[list->size].id = 0;
+    list->edges[list->size].length = length;
+    list->size++;
+    return true;
+}
+
+/**
+ * @brief Ograniczone wyszukiwanie dróg omijających kontraktowane miasto
+ * Szuka wśród miast jeszcze nie skontraktowanych dróg z sąsiada o podanym
+ * indeksie do sąsiadów o większych indeksach. Kończy się, gdy wszyscy zostaną
+ * odwiedzeni lub odległość przekroczy długość najdłuższej drogi przez
+ * kontraktowane miasto.
+ * @param builder -- stan budowy
+ * @param node -- kontraktowane miasto
+ * @param index -- indeks sąsiada, z którego szukamy
+ * @param limit -- odległość, powyżej której nie szukamy
+ */
+static void witnessSearch(Builder *builder, unsigned node, unsigned index,
+                          unsigned long long limit)
+{
+    if (++builder->currentStamp == 0)
+    {
+        for (unsigned i = 0; i < builder->count; ++i)
+        {
+            builder->stamp[i] = 0;
+            builder->targetStamp[i] = 0;
+        }
+        builder->currentStamp = 1;
+    }
+
+    EdgeList *neighbours = &builder->working[node];
+    unsigned remaining = neighbours->size - index - 1;
+    for (unsigned i = index + 1; i < neighbours->size; ++i)
+    {
+        builder->targetStamp[neighbours->edges[i].target] = builder->currentStamp;
+    }
+
+    unsigned source = neighbours->edges[index].target;
+    builder->heap.size = 0;
+    builder->distance[source] = 0;
+    builder->stamp[source] = builder->currentStamp;
+    // if the push fails no witness is found, which only adds shortcuts
+    heapPush(&builder->heap, 0, source);
+
+    unsigned settledCount = 0;
+    while (builder->heap.size > 0)
+    {
+        HeapItem item = heapPop(&builder->heap);
+        unsigned long long distance = item.key;
+        if (distance != builder->distance[item.node]) continue; // outdated
+        if (distance > limit || ++settledCount > WITNESS_SETTLE_LIMIT) break;
+
+        if (builder->targetStamp[item.node] == builder->currentStamp &&
+            --remaining == 0)
+        {
+            break;
+        }
+
+        EdgeList *list = &builder->working[item.node];
+        for (unsigned i = 0; i < list->size; ++i)
+        {
+            unsigned target = list->edges[i].target;
+            if (target == node) continue;
+
+            unsigned long long newDistance = distance + list->edges[i].length;
+            if (builder->stamp[target] != builder->currentStamp ||
+                newDistance < builder->distance[target])
+            {
+                builder->stamp[target] = builder->currentStamp;
+                builder->distance[target] = newDistance;
+                heapPush(&builder->heap, newDistance, target);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Wyznacza skróty potrzebne przy kontrakcji miasta i ewentualnie je dodaje
+ * Skrót między sąsiadami jest potrzebny, jeśli nie ma między nimi ściśle
+ * krótszej drogi omijającej kontraktowane miasto.
+ * @param builder -- stan budowy
+ * @param node -- kontraktowane miasto
+ * @param apply -- czy dodać skróty do grafu
+ * @return Liczba potrzebnych skrótów
+ */
+static long long processNode(Builder *builder, unsigned node, bool apply)
+{
+    EdgeList *list = &builder->working[node];
+    long long shortcuts = 0;
+
+    for (unsigned i = 0; i < list->size; ++i)
+    {
+        unsigned first = list->edges[i].target;
+        unsigned long long firstLength = list->edges[i].length;
+
+        unsigned long long limit = 0;
+        for (unsigned j = i + 1; j < list->size; ++j)
+        {
+            if (firstLength + list->edges[j].length > limit)
+            {
+                limit = firstLength + list->edges[j].length;
+            }
+        }
+        if (i + 1 == list->size) break;
+
+        witnessSearch(builder, node, i, limit);
+
+        for (unsigned j = i + 1; j < list->size; ++j)
+        {
+            unsigned second = list->edges[j].target;
+            unsigned long long via = firstLength + list->edges[j].length;
+
+            if (builder->stamp[second] == builder->currentStamp &&
+                builder->distance[second] < via)
+            {
+                continue; // a strictly shorter way around exists
+            }
+            // paths of length INFINITY or more count as absent, so no
+            // shortest path can use such a shortcut
+            if (via >= INFINITY) continue;
+
+            shortcuts++;
+            if (apply && (!addOrShorten(&builder->working[first], second, via) ||
+                          !addOrShorten(&builder->working[second], first, via)))
+            {
+                builder->failed = true;
+            }
+        }
+    }
+
+    return shortcuts;
+}
+
+/**
+ * @brief Priorytet kontrakcji miasta: im mniejszy, tym wcześniej je kontraktujemy
+ * @param builder -- stan budowy
+ * @param node -- miasto
+ * @return Różnica liczby dodanych skrótów i usuniętych krawędzi, powiększona
+ * o liczbę skontraktowanych sąsiadów, aby kontrakcja była równomierna
+ */
+static long long contractionPriority(Builder *builder, unsigned node)
+{
+    return processNode(builder, node, false) -
+           (long long) builder->working[node].size +
+           builder->contractedNeighbours[node];
+}
+
+/**
+ * @brief Kontraktuje miasto: dodaje skróty, zapamiętuje krawędzie w górę
+ * hierarchii i usuwa miasto z grafu
+ * @param builder -- stan budowy
+ * @param node -- miasto
+ */
+static void contract(Builder *builder, unsigned node)
+{
+    processNode(builder, node, true);
+
+    EdgeList *list = &builder->working[node];
+    for (unsigned i = 0; i < list->size; ++i)
+    {
+        EdgeList *neighbour = &builder->working[list->edges[i].target];
+        for (unsigned j = 0; j < neighbour->size; ++j)
+        {
+            if (neighbour->edges[j].target == node)
+            {
+                neighbour->edges[j] = neighbour->edges[--neighbour->size];
+                break;
+            }
+        }
+        builder->contractedNeighbours[list->edges[i].target]++;
+    }
+
+    // all remaining neighbours will be contracted later, so these edges go up
+    builder->upward[node] = *list;
+    list->edges = NULL;
+    list->size = list->capacity = 0;
+    builder->contracted[node] = true;
+}
+
+/**
+ * @brief Zwalnia pamięć stanu budowy
+ * @param builder -- stan budowy
+ */
+static void removeBuilder(Builder *builder)
+{
+    for (unsigned i = 0; i < builder->count; ++i)
+    {
+        if (builder->working != NULL) free(builder->working[i].edges);
+        if (builder->upward != NULL) free(builder->upward[i].edges);
+    }
+
+    free(builder->cities);
+    free(builder->working);
+    free(builder->upward);
+    free(builder->contracted);
+    free(builder->contractedNeighbours);
+    free(builder->rank);
+    free(builder->distance);
+    free(builder->stamp);
+    free(builder->targetStamp);
+    free(builder->heap.items);
+}
+
+/**
+ * @brief Inicjalizuje stan budowy: kopiuje odcinki dróg z migawki sąsiedztwa
+ * @param builder -- stan budowy
+ * @param map -- wskaźnik na mapę
+ * @return false, jeśli nie udało się zaalokować pamięci; w przeciwnym wypadku true
+ */
+static bool initBuilder(Builder *builder, Map *map)
+{
+    unsigned count = map->cityCount;
+
+    builder->count = count;
+    builder->cities = malloc(sizeof(City *) * count);
+    builder->working = calloc(count, sizeof(EdgeList));
+    builder->upward = calloc(count, sizeof(EdgeList));
+    builder->contracted = calloc(count, sizeof(bool));
+    builder->contractedNeighbours = calloc(count, sizeof(unsigned));
+    builder->rank = malloc(sizeof(unsigned) * count);
+    builder->distance = malloc(sizeof(unsigned long long) * count);
+    builder->stamp = calloc(count, sizeof(unsigned));
+    builder->targetStamp = calloc(count, sizeof(unsigned));
+    builder->currentStamp = 0;
+    builder->heap.items = NULL;
+    builder->heap.size = builder->heap.capacity = 0;
+    builder->failed = false;
+
+    if (builder->cities == NULL || builder->working == NULL ||
+        builder->upward == NULL || builder->contracted == NULL ||
+        builder->contractedNeighbours == NULL || builder->rank == NULL ||
+        builder->distance == NULL || builder->stamp == NULL ||
+        builder->targetStamp == NULL || !refreshAdjacency(map))
+    {
+        return false;
+    }
+
+    Adjacency *graph = map->adjacency;
+    for (uint32_t id = 0; id < count; ++id)
+    {
+        builder->cities[id] = map->cityById[id];
+
+        for (uint32_t i = graph->offsets[id]; i < graph->ends[id]; ++i)
+        {
+            if (!addOrShorten(&builder->working[id], graph->neighbours[i],
+                              graph->lengths[i]))
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Kontraktuje wszystkie miasta, wybierając leniwie to o najmniejszym
+ * priorytecie
+ * @param builder -- stan budowy
+ * @return false, jeśli nie udało się zaalokować pamięci; w przeciwnym wypadku true
+ */
+static bool contractAll(Builder *builder)
+{
+    LazyHeap order = {NULL, 0, 0};
+
+    for (unsigned i = 0; i < builder->count; ++i)
+    {
+        if (!heapPush(&order, contractionPriority(builder, i), i))
+        {
+            free(order.items);
+            return false;
+        }
+    }
+
+    unsigned nextRank = 0;
+    while (order.size > 0 && !builder->failed)
+    {
+        HeapItem item = heapPop(&order);
+        if (builder->contracted[item.node]) continue;
+
+        // priorities of neighbours change after each contraction, so they
+        // are recomputed only when the city reaches the top
+        long long priority = contractionPriority(builder, item.node);
+        if (order.size > 0 && priority > order.items[0].key)
+        {
+            if (!heapPush(&order, priority, item.node)) builder->failed = true;
+            continue;
+        }
+
+        contract(builder, item.node);
+        builder->rank[item.node] = nextRank++;
+    }
+
+    free(order.items);
+    return !builder->failed;
+}
+
+/**
+ * @brief Przepisuje krawędzie w górę ze stanu budowy do tablic ciągłych
+ * hierarchii numerowanych rangą i tworzy krawędzie w dół
+ * @param hierarchy -- hierarchia z zaalokowanymi tablicami miast i przesunięć
+ * @param builder -- stan budowy po kontrakcji wszystkich miast
+ * @param edgesCount -- łączna liczba krawędzi w górę
+ * @return false, jeśli nie udało się zaalokować pamięci; w przeciwnym wypadku true
+ */
+static bool fillEdges(struct Hierarchy *hierarchy, Builder *builder,
+                      unsigned edgesCount)
+{
+    unsigned count = builder->count;
+
+    hierarchy->upEdges = malloc(sizeof(HierarchyEdge) * (edgesCount + 1));
+    hierarchy->downEdges = malloc(sizeof(HierarchyEdge) * (edgesCount + 1));
+    hierarchy->edgeStamp = calloc(edgesCount + 1, sizeof(unsigned));
+    if (hierarchy->upEdges == NULL || hierarchy->downEdges == NULL ||
+        hierarchy->edgeStamp == NULL)
+    {
+        return false;
+    }
+
+    for (unsigned i = 0; i <= count; ++i)
+    {
+        hierarchy->upOffsets[i] = 0;
+        hierarchy->downOffsets[i] = 0;
+    }
+
+    for (unsigned node = 0; node < count; ++node)
+    {
+        unsigned rank = builder->rank[node];
+        hierarchy->cities[rank] = builder->cities[node];
+        hierarchy->upOffsets[rank + 1] = builder->upward[node].size;
+        for (unsigned i = 0; i < builder->upward[node].size; ++i)
+        {
+            hierarchy->downOffsets[
+                    builder->rank[builder->upward[node].edges[i].target] + 1]++;
+        }
+    }
+
+    for (unsigned i = 0; i < count; ++i)
+    {
+        hierarchy->upOffsets[i + 1] += hierarchy->upOffsets[i];
+        hierarchy->downOffsets[i + 1] += hierarchy->downOffsets[i];
+    }
+
+    // downOffsets are advanced while filling and restored afterwards
+    for (unsigned node = 0; node < count; ++node)
+    {
+        unsigned rank = builder->rank[node];
+        unsigned position = hierarchy->upOffsets[rank];
+
+        for (unsigned i = 0; i < builder->upward[node].size; ++i, ++position)
+        {
+            unsigned target = builder->rank[builder->upward[node].edges[i].target];
+            unsigned long long length = builder->upward[node].edges[i].length;
+
+            hierarchy->upEdges[position].target = target;
+            hierarchy->upEdges[position].id = position;
+            hierarchy->upEdges[position].length = length;
+
+            unsigned down = hierarchy->downOffsets[target]++;
+            hierarchy->downEdges[down].target = rank;
+            hierarchy->downEdges[down].id = position;
+            hierarchy->downEdges[down].length = length;
+        }
+    }
+
+    for (unsigned i = count; i > 0; --i)
+    {
+        hierarchy->downOffsets[i] = hierarchy->downOffsets[i - 1];
+    }
+    hierarchy->downOffsets[0] = 0;
+
+    for (unsigned rank = 0; rank < count; ++rank)
+    {
+        hierarchy->cities[rank]->hierarchyRank = rank;
+    }
+
+    return true;
+}
+
+void removeContractionHierarchy(Map *map)
+{
+    struct Hierarchy *hierarchy = map->hierarchy;
+    if (hierarchy == NULL) return;
+
+    free(hierarchy->cities);
+    free(hierarchy->upOffsets);
+    free(hierarchy->upEdges);
+    free(hierarchy->downOffsets);
+    free(hierarchy->downEdges);
+    for (int side = 0; side < 2; ++side)
+    {
+        free(hierarchy->distance[side]);
+        free(hierarchy->stamp[side]);
+        free(hierarchy->mark[side]);
+        free(hierarchy->heap[side].items);
+    }
+    free(hierarchy->edgeStamp);
+    free(hierarchy->list);
+    free(hierarchy->segments);
+    free(hierarchy);
+
+    map->hierarchy = NULL;
+}
+
+bool buildContractionHierarchy(Map *map)
+{
+    removeContractionHierarchy(map);
+
+    Builder builder;
+    if (!initBuilder(&builder, map) || builder.count == 0 ||
+        !contractAll(&builder))
+    {
+        removeBuilder(&builder);
+        return false;
+    }
+
+    struct Hierarchy *hierarchy = calloc(1, sizeof(struct Hierarchy));
+    if (hierarchy == NULL)
+    {
+        removeBuilder(&builder);
+        return false;
+    }
+    map->hierarchy = hierarchy;
+
+    unsigned count = builder.count;
+    unsigned edgesCount = 0;
+    for (unsigned i = 0; i < count; ++i) edgesCount += builder.upward[i].size;
+
+    hierarchy->count = count;
+    hierarchy->graphVersion = map->graphVersion;
+    hierarchy->cities = malloc(sizeof(City *) * count);
+    hierarchy->upOffsets = malloc(sizeof(unsigned) * (count + 1));
+    hierarchy->downOffsets = malloc(sizeof(unsigned) * (count + 1));
+    for (int side = 0; side < 2; ++side)
+    {
+        hierarchy->distance[side] = malloc(sizeof(unsigned long long) * count);
+        hierarchy->stamp[side] = calloc(count, sizeof(unsigned));
+        hierarchy->mark[side] = calloc(count, sizeof(unsigned));
+    }
+
+    bool success = hierarchy->cities != NULL && hierarchy->upOffsets != NULL &&
+                   hierarchy->downOffsets != NULL;
+    for (int side = 0; side < 2; ++side)
+    {
+        success = success && hierarchy->distance[side] != NULL &&
+                  hierarchy->stamp[side] != NULL && hierarchy->mark[side] != NULL;
+    }
+    success = success && fillEdges(hierarchy, &builder, edgesCount);
+
+    removeBuilder(&builder);
+    if (!success)
+    {
+        removeContractionHierarchy(map);
+        return false;
+    }
+
+    return true;
+}
+
+bool refreshContractionHierarchy(Map *map)
+{
+    if (map->hierarchy != NULL &&
+        map->hierarchy->graphVersion == map->graphVersion)
+    {
+        return true;
+    }
+
+    return buildContractionHierarchy(map);
+}
+
+bool hierarchyIsFresh(Map *map, City *start, City *finish)
+{
+    return map->hierarchy != NULL &&
+           map->hierarchy->graphVersion == map->graphVersion &&
+           start->hierarchyRank < map->hierarchy->count &&
+           finish->hierarchyRank < map->hierarchy->count &&
+           map->hierarchy->cities[start->hierarchyRank] == start &&
+           map->hierarchy->cities[finish->hierarchyRank] == finish;
+}
+
+/**
+ * @brief Rozpoczyna nowe zapytanie, unieważniając stan poprzedniego
+ * @param hierarchy -- hierarchia
+ */
+static void nextQuery(struct Hierarchy *hierarchy)
+{
+    if (++hierarchy->queryStamp == 0)
+    {
+        unsigned edgesCount = hierarchy->upOffsets[hierarchy->count];
+        for (unsigned i = 0; i < hierarchy->count; ++i)
+        {
+            for (int side = 0; side < 2; ++side)
+            {
+                hierarchy->stamp[side][i] = 0;
+                hierarchy->mark[side][i] = 0;
+            }
+        }
+        for (unsigned i = 0; i < edgesCount; ++i) hierarchy->edgeStamp[i] = 0;
+        hierarchy->queryStamp = 1;
+    }
+
+    hierarchy->heap[0].size = hierarchy->heap[1].size = 0;
+    hierarchy->listSize = 0;
+    hierarchy->segmentsSize = 0;
+}
+
+/**
+ * @brief Ustawia odległość miasta w wyszukiwaniu i wkłada je do kopca
+ * @param hierarchy -- hierarchia
+ * @param side -- 0 dla wyszukiwania od początku, 1 od końca
+ * @param node -- ranga miasta
+ * @param distance -- nowa odległość
+ * @return false, jeśli nie udało się zaalokować pamięci; w przeciwnym wypadku true
+ */
+static bool reach(struct Hierarchy *hierarchy, int side, unsigned node,
+                  unsigned long long distance)
+{
+    hierarchy->stamp[side][node] = hierarchy->queryStamp;
+    hierarchy->distance[side][node] = distance;
+    return heapPush(&hierarchy->heap[side], distance, node);
+}
+
+/**
+ * @brief Odległość miasta w wyszukiwaniu bieżącego zapytania
+ * @param hierarchy -- hierarchia
+ * @param side -- 0 dla wyszukiwania od początku, 1 od końca
+ * @param node -- ranga miasta
+ * @return Odległość lub NO_DISTANCE, jeśli miasto nie zostało osiągnięte
+ */
+static inline unsigned long long distanceOf(struct Hierarchy *hierarchy,
+                                            int side, unsigned node)
+{
+    return hierarchy->stamp[side][node] == hierarchy->queryStamp
+           ? hierarchy->distance[side][node] : NO_DISTANCE;
+}
+
+/**
+ * @brief Dopisuje miasto do pomocniczej listy
+ * @param hierarchy -- hierarchia
+ * @param node -- ranga miasta
+ * @return false, jeśli nie udało się zaalokować pamięci; w przeciwnym wypadku true
+ */
+static bool appendNode(struct Hierarchy *hierarchy, unsigned node)
+{
+    unsigned *list = reserve(hierarchy->list, &hierarchy->listCapacity,
+                             hierarchy->listSize + 1, sizeof(unsigned));
+    if (list == NULL) return false;
+    hierarchy->list = list;
+
+    hierarchy->list[hierarchy->listSize++] = node;
+    return true;
+}
+
+/**
+ * @brief Dopisuje miasto do pomocniczej listy, jeśli jeszcze go na niej nie ma
+ * @param hierarchy -- hierarchia
+ * @param side -- strona, dla której miasto jest oznaczane
+ * @param node -- ranga miasta
+ * @return false, jeśli nie udało się zaalokować pamięci; w przeciwnym wypadku true
+ */
+static bool listNode(struct Hierarchy *hierarchy, int side, unsigned node)
+{
+    if (hierarchy->mark[side][node] == hierarchy->queryStamp) return true;
+
+    hierarchy->mark[side][node] = hierarchy->queryStamp;
+    return appendNode(hierarchy, node);
+}
+
+/**
+ * @brief Odkłada krawędź na stos krawędzi do rozwinięcia
+ * @param hierarchy -- hierarchia
+ * @param from -- miasto bliższe początku
+ * @param to -- miasto dalsze od początku
+ * @param edge -- krawędź między nimi
+ * @param offset -- odległość miasta 'from' od początku
+ * @return false, jeśli nie udało się zaalokować pamięci; w przeciwnym wypadku true
+ */
+static bool pushSegment(struct Hierarchy *hierarchy, unsigned from, unsigned to,
+                        const HierarchyEdge *edge, unsigned long long offset)
+{
+    Segment *segments = reserve(hierarchy->segments,
+                                &hierarchy->segmentsCapacity,
+                                hierarchy->segmentsSize + 1, sizeof(Segment));
+    if (segments == NULL) return false;
+    hierarchy->segments = segments;
+
+    Segment *segment = &segments[hierarchy->segmentsSize++];
+    segment->from = from;
+    segment->to = to;
+    segment->id = edge->id;
+    segment->length = edge->length;
+    segment->offset = offset;
+    return true;
+}
+
+/**
+ * @brief Wyszukiwanie w górę hierarchii od obu końców jednocześnie
+ * Każda strona jest prowadzona, dopóki jej najmniejszy klucz nie przekroczy
+ * długości najlepszej drogi, więc wszystkie miasta spotkania najkrótszych
+ * dróg mają dokładne odległości z obu stron.
+ * @param hierarchy -- hierarchia
+ * @param source -- ranga miasta początkowego
+ * @param target -- ranga miasta końcowego
+ * @param best -- długość najkrótszej drogi lub NO_DISTANCE
+ * @return false, jeśli nie udało się zaalokować pamięci; w przeciwnym wypadku true
+ */
+static bool upwardSearch(struct Hierarchy *hierarchy, unsigned source,
+                         unsigned target, unsigned long long *best)
+{
+    *best = NO_DISTANCE;
+    if (!reach(hierarchy, 0, source, 0) || !reach(hierarchy, 1, target, 0))
+    {
+        return false;
+    }
+
+    while (hierarchy->heap[0].size > 0 || hierarchy->heap[1].size > 0)
+    {
+        int side = hierarchy->heap[1].size == 0 ||
+                   (hierarchy->heap[0].size > 0 &&
+                    hierarchy->heap[0].items[0].key <=
+                    hierarchy->heap[1].items[0].key) ? 0 : 1;
+
+        HeapItem item = heapPop(&hierarchy->heap[side]);
+        unsigned long long distance = item.key;
+        if (distance != distanceOf(hierarchy, side, item.node)) continue;
+        if (distance > *best)
+        {
+            hierarchy->heap[side].size = 0; // nothing useful left on this side
+            continue;
+        }
+
+        unsigned long long other = distanceOf(hierarchy, 1 - side, item.node);
+        if (other != NO_DISTANCE)
+        {
+            // every meeting city of a shortest path passes here
+            if (!appendNode(hierarchy, item.node)) return false;
+            if (distance + other < *best) *best = distance + other;
+        }
+
+        for (unsigned i = hierarchy->upOffsets[item.node];
+             i < hierarchy->upOffsets[item.node + 1]; ++i)
+        {
+            unsigned next = hierarchy->upEdges[i].target;
+            unsigned long long newDistance = distance +
+                                             hierarchy->upEdges[i].length;
+            if (newDistance < INFINITY &&
+                newDistance < distanceOf(hierarchy, side, next) &&
+                !reach(hierarchy, side, next, newDistance))
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Zbiera krawędzie hierarchii leżące na najkrótszych drogach
+ * Od miast spotkania idzie w dół drzew obu wyszukiwań po krawędziach, na
+ * których odległość rośnie dokładnie o ich długość.
+ * @param hierarchy -- hierarchia
+ * @param best -- długość najkrótszej drogi
+ * @return false, jeśli nie udało się zaalokować pamięci; w przeciwnym wypadku true
+ */
+static bool collectSegments(struct Hierarchy *hierarchy, unsigned long long best)
+{
+    // the list holds candidates recorded by upwardSearch; keep the real
+    // meeting cities at its beginning, shared by both walks
+    unsigned candidates = hierarchy->listSize;
+    hierarchy->listSize = 0;
+    for (unsigned i = 0; i < candidates; ++i)
+    {
+        unsigned node = hierarchy->list[i];
+        if (distanceOf(hierarchy, 0, node) + distanceOf(hierarchy, 1, node) ==
+            best && hierarchy->mark[0][node] != hierarchy->queryStamp)
+        {
+            hierarchy->mark[0][node] = hierarchy->queryStamp;
+            hierarchy->mark[1][node] = hierarchy->queryStamp;
+            hierarchy->list[hierarchy->listSize++] = node;
+        }
+    }
+    unsigned meetings = hierarchy->listSize;
+
+    for (int side = 0; side < 2; ++side)
+    {
+        hierarchy->listSize = meetings;
+        for (unsigned i = 0; i < hierarchy->listSize; ++i)
+        {
+            unsigned upper = hierarchy->list[i];
+            unsigned long long upperDistance = distanceOf(hierarchy, side, upper);
+
+            for (unsigned j = hierarchy->downOffsets[upper];
+                 j < hierarchy->downOffsets[upper + 1]; ++j)
+            {
+                const HierarchyEdge *edge = &hierarchy->downEdges[j];
+                unsigned long long lowerDistance =
+                        distanceOf(hierarchy, side, edge->target);
+                if (lowerDistance == NO_DISTANCE ||
+                    lowerDistance + edge->length != upperDistance)
+                {
+                    continue;
+                }
+
+                bool success = side == 0
+                        ? pushSegment(hierarchy, edge->target, upper, edge,
+                                      lowerDistance)
+                        : pushSegment(hierarchy, upper, edge->target, edge,
+                                      best - upperDistance);
+                if (!success || !listNode(hierarchy, side, edge->target))
+                {
+                    return false;
+                }
+            }
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Zapisuje w mieście odległość od początku najkrótszej drogi
+ * @param map -- wskaźnik na mapę
+ * @param city -- miasto
+ * @param distance -- odległość od początku
+ */
+static inline void labelCity(Map *map, City *city, unsigned long long distance)
+{
+    touchCity(map, city);
+    city->distance = distance;
+    city->visited = true;
+}
+
+/**
+ * @brief Rozwija zebrane krawędzie hierarchii do odcinków dróg mapy
+ * Skrót między miastami jest rozwijany przez wszystkie miasta o niższej randze,
+ * przez które prowadzi droga tej samej długości. Końce każdego odcinka drogi
+ * mapy leżącego na najkrótszej drodze dostają swoją odległość od początku.
+ * @param map -- wskaźnik na mapę
+ * @param hierarchy -- hierarchia
+ * @return false, jeśli nie udało się zaalokować pamięci; w przeciwnym wypadku true
+ */
+static bool unpackSegments(Map *map, struct Hierarchy *hierarchy)
+{
+    while (hierarchy->segmentsSize > 0)
+    {
+        Segment segment = hierarchy->segments[--hierarchy->segmentsSize];
+        if (hierarchy->edgeStamp[segment.id] == hierarchy->queryStamp) continue;
+        hierarchy->edgeStamp[segment.id] = hierarchy->queryStamp;
+
+        City *from = hierarchy->cities[segment.from];
+        City *to = hierarchy->cities[segment.to];
+        Road *road = findRoadBetween(map, from, to);
+        if (road != NULL && road->length == segment.length)
+        {
+            labelCity(map, from, segment.offset);
+            labelCity(map, to, segment.offset + segment.length);
+        }
+
+        // middle cities are found from the end with fewer edges down
+        bool fromIsLow = hierarchy->downOffsets[segment.from + 1] -
+                         hierarchy->downOffsets[segment.from] <=
+                         hierarchy->downOffsets[segment.to + 1] -
+                         hierarchy->downOffsets[segment.to];
+        unsigned low = fromIsLow ? segment.from : segment.to;
+        unsigned high = fromIsLow ? segment.to : segment.from;
+
+        for (unsigned i = hierarchy->downOffsets[low];
+             i < hierarchy->downOffsets[low + 1]; ++i)
+        {
+            const HierarchyEdge *lowEdge = &hierarchy->downEdges[i];
+            unsigned middle = lowEdge->target;
+            if (middle >= high || lowEdge->length >= segment.length) continue;
+
+            for (unsigned j = hierarchy->upOffsets[middle];
+                 j < hierarchy->upOffsets[middle + 1]; ++j)
+            {
+                const HierarchyEdge *highEdge = &hierarchy->upEdges[j];
+                if (highEdge->target != high ||
+                    lowEdge->length + highEdge->length != segment.length)
+                {
+                    continue;
+                }
+
+                const HierarchyEdge *first = fromIsLow ? lowEdge : highEdge;
+                const HierarchyEdge *second = fromIsLow ? highEdge : lowEdge;
+                if (!pushSegment(hierarchy, segment.from, middle, first,
+                                 segment.offset) ||
+                    !pushSegment(hierarchy, middle, segment.to, second,
+                                 segment.offset + first->length))
+                {
+                    return false;
+                }
+                break;
+            }
+        }
+    }
+
+    return true;
+}
+
+Route *hierarchyDkstra(Map *map, City *start, City *finish)
+{
+    if (!refreshAdjacency(map)) return NULL;
+
+    struct Hierarchy *hierarchy = map->hierarchy;
+    nextQuery(hierarchy);
+
+    // paths of length INFINITY or more count as absent, as in relaxRoad
+    unsigned long long best;
+    if (!upwardSearch(hierarchy, start->hierarchyRank, finish->hierarchyRank,
+                      &best) || best >= INFINITY)
+    {
+        return NULL;
+    }
+
+    startNewSearch(map);
+    labelCity(map, start, 0);
+    if (!collectSegments(hierarchy, best) || !unpackSegments(map, hierarchy))
+    {
+        return NULL;
+    }
+
+    if (!finish->visited) return NULL;
+
+    // the hierarchy only gives distances, so ages and predecessors are
+    // decided afterwards over all shortest paths
+    if (!labelShortestPaths(map, start, finish)) return NULL;
+
+    return routeFromPrevious(map, start, finish);
+}
@@ -0,0 +1,57 @@
+/** @file
+ * Interfejs hierarchii kontrakcyjnej (contraction hierarchy) mapy dróg
+ *
+ * @author Filip Bieńkowski 407686
+ * @copyright Uniwersytet Warszawski
+ */
+
+#ifndef DROGI_MAP_CONTRACTION_H
+#define DROGI_MAP_CONTRACTION_H
+
+#include "map.h"
+
+/**
+ * @brief Wartość pola hierarchyRank miasta spoza hierarchii
+ */
+#define NOT_RANKED UINT_MAX
+
+/**
+ * @brief Sprawdza, czy hierarchia może być użyta do wyszukiwania
+ * Hierarchia jest aktualna, jeśli od jej zbudowania nie dodano ani nie
+ * usunięto żadnego odcinka drogi, a oba miasta do niej należą.
+ * @param map -- wskaźnik na mapę
+ * @param start -- miasto początkowe
+ * @param finish -- miasto końcowe
+ * @return Wartość @p true jeśli tak, wartość @p false w przeciwnym wypadku
+ */
+bool hierarchyIsFresh(Map *map, City *start, City *finish);
+
+/**
+ * @brief Buduje hierarchię kontrakcyjną, jeśli nie jest aktualna
+ * @param map -- wskaźnik na mapę
+ * @return Wartość @p true jeśli hierarchia jest aktualna, wartość @p false
+ * jeśli mapa nie zawiera żadnego miasta lub nie udało się zaalokować pamięci
+ */
+bool refreshContractionHierarchy(Map *map);
+
+/**
+ * @brief Wyszukiwanie najkrótszej drogi w hierarchii kontrakcyjnej
+ * Wyszukiwanie idzie w górę hierarchii od obu końców. Wszystkie najkrótsze
+ * drogi są następnie rozwijane do odcinków drogi mapy, po czym najgorszy wiek
+ * i poprzednicy są ustalani tak jak w funkcji dkstra, więc wynik jest taki
+ * sam. Lata budowy są odczytywane z odcinków mapy, więc remonty nie
+ * wymagają przebudowy hierarchii. Nie omija miast żadnej drogi krajowej.
+ * @param map -- wskaźnik na mapę z aktualną hierarchią
+ * @param start -- miasto początkowe
+ * @param finish -- miasto końcowe
+ * @return Potencjalna droga krajowa, albo NULL jeśli nie ma drogi z A do B
+ */
+Route *hierarchyDkstra(Map *map, City *start, City *finish);
+
+/**
+ * @brief Usuwa hierarchię kontrakcyjną mapy
+ * @param map -- wskaźnik na mapę
+ */
+void removeContractionHierarchy(Map *map);
+
+#endif //DROGI_MAP_CONTRACTION_H
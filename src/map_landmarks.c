@@ -0,0 +1,283 @@
+/** @file
+ * Implementacja wyszukiwania dróg algorytmem A* z punktami orientacyjnymi
+ *
+ * @author Filip Bieńkowski 407686
+ * @copyright Uniwersytet Warszawski
+ */
+
+#include "map_landmarks.h"
+#include "map_operations.h"
+#include "map_adjacency.h"
+
+#include <stdlib.h>
+
+/**
+ * @brief Odległość od punktu orientacyjnego miasta, którego z niego nie widać
+ */
+#define NOT_REACHED ULLONG_MAX
+
+/**
+ * @brief Dolne ograniczenie odległości między miastami
+ * Z nierówności trójkąta odległość między miastami jest nie mniejsza niż
+ * różnica ich odległości od dowolnego punktu orientacyjnego. Takie
+ * oszacowanie jest spójne, więc A* odwiedza miasta z dokładną odległością.
+ * @param landmarks -- punkty orientacyjne
+ * @param city -- pierwsze miasto
+ * @param finish -- drugie miasto
+ * @return Dolne ograniczenie, lub NOT_REACHED jeśli miasta leżą w różnych
+ * spójnych składowych
+ */
+static unsigned long long lowerBound(Landmarks *landmarks, City *city,
+                                     City *finish)
+{
+    unsigned long long bound = 0;
+
+    for (unsigned i = 0; i < landmarks->count; ++i)
+    {
+        unsigned long long toCity = city->landmarkDistances[i];
+        unsigned long long toFinish = finish->landmarkDistances[i];
+
+        if (toCity == NOT_REACHED || toFinish == NOT_REACHED)
+        {
+            // landmark sees only one of them, so there is no path between them
+            if (toCity != toFinish) return NOT_REACHED;
+            continue;
+        }
+
+        unsigned long long difference = toCity > toFinish ? toCity - toFinish
+                                                          : toFinish - toCity;
+        if (difference > bound) bound = difference;
+    }
+
+    return bound;
+}
+
+/**
+ * @brief Zapisuje w miastach odległości od podanego punktu orientacyjnego
+ * Odległości są dokładne także wtedy, gdy przekraczają UINT_MAX, bo tylko
+ * wtedy różnice odległości są dolnymi ograniczeniami.
+ * @param map -- wskaźnik na mapę
+ * @param landmark -- punkt orientacyjny
+ * @param index -- numer punktu orientacyjnego
+ * @return false, jeśli nie udało się zaalokować pamięci; w przeciwnym wypadku true
+ */
+static bool computeDistances(Map *map, City *landmark, unsigned index)
+{
+    Adjacency *graph = map->adjacency;
+
+    // the distances do not fit in city->distance, so the search keeps them
+    // straight in the table
+    for (uint32_t id = 0; id < map->cityCount; ++id)
+    {
+        map->cityById[id]->landmarkDistances[index] = NOT_REACHED;
+    }
+
+    startNewSearch(map);
+    touchCity(map, landmark);
+    landmark->landmarkDistances[index] = 0;
+    if (!pushOrDecrease(map->queue, landmark, 0)) return false;
+
+    while (!isQueueEmpty(map->queue))
+    {
+        City *actCity = popMin(map->queue);
+        actCity->visited = true;
+        unsigned long long distance = actCity->landmarkDistances[index];
+
+        for (uint32_t i = graph->offsets[actCity->id];
+             i < graph->ends[actCity->id]; ++i)
+        {
+            City *neighbour = map->cityById[graph->neighbours[i]];
+            touchCity(map, neighbour);
+            if (neighbour->visited) continue;
+
+            unsigned long long newDistance = distance + graph->lengths[i];
+            if (newDistance < neighbour->landmarkDistances[index])
+            {
+                neighbour->landmarkDistances[index] = newDistance;
+                if (!pushOrDecrease(map->queue, neighbour, newDistance))
+                {
+                    return false;
+                }
+            }
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Wybiera miasto najdalsze od wyznaczonych już punktów orientacyjnych
+ * Miasta nieosiągalne z żadnego punktu są traktowane jako najdalsze, dzięki
+ * czemu każda spójna składowa dostaje swój punkt.
+ * @param map -- wskaźnik na mapę
+ * @param count -- liczba wyznaczonych punktów
+ * @return Wybrane miasto, lub NULL jeśli każde miasto jest już punktem
+ */
+static City *farthestCity(Map *map, unsigned count)
+{
+    City *farthest = NULL;
+    unsigned long long farthestDistance = 0;
+
+    for (uint32_t id = 0; id < map->cityCount; ++id)
+    {
+        City *city = map->cityById[id];
+        unsigned long long nearest = NOT_REACHED;
+        for (unsigned i = 0; i < count; ++i)
+        {
+            if (city->landmarkDistances[i] < nearest)
+            {
+                nearest = city->landmarkDistances[i];
+            }
+        }
+
+        if (nearest > farthestDistance)
+        {
+            farthestDistance = nearest;
+            farthest = city;
+        }
+    }
+
+    return farthest;
+}
+
+void removeLandmarks(Map *map)
+{
+    for (uint32_t id = 0; id < map->cityCount; ++id)
+    {
+        free(map->cityById[id]->landmarkDistances);
+        map->cityById[id]->landmarkDistances = NULL;
+    }
+
+    free(map->landmarks);
+    map->landmarks = NULL;
+}
+
+bool prepareLandmarks(Map *map, unsigned count)
+{
+    removeLandmarks(map);
+    if (count == 0) return true;
+
+    for (uint32_t id = 0; id < map->cityCount; ++id)
+    {
+        City *city = map->cityById[id];
+        city->landmarkDistances = malloc(sizeof(unsigned long long) * count);
+        if (city->landmarkDistances == NULL)
+        {
+            removeLandmarks(map);
+            return false;
+        }
+    }
+
+    City *first = map->cityCount > 0 ? map->cityById[0] : NULL;
+    if (first == NULL || !refreshAdjacency(map))
+    {
+        removeLandmarks(map);
+        return false;
+    }
+
+    Landmarks *landmarks = malloc(sizeof(Landmarks));
+    if (landmarks == NULL)
+    {
+        removeLandmarks(map);
+        return false;
+    }
+    landmarks->count = 0;
+    landmarks->roadAdditions = map->roadAdditions;
+
+    for (City *next = first; next != NULL && landmarks->count < count;
+         next = farthestCity(map, landmarks->count))
+    {
+        if (!computeDistances(map, next, landmarks->count))
+        {
+            free(landmarks);
+            removeLandmarks(map);
+            return false;
+        }
+        landmarks->count++;
+    }
+
+    map->landmarks = landmarks;
+    return true;
+}
+
+bool landmarksAreFresh(Map *map, City *start, City *finish)
+{
+    return map->landmarks != NULL &&
+           map->landmarks->roadAdditions == map->roadAdditions &&
+           start->landmarkDistances != NULL &&
+           finish->landmarkDistances != NULL;
+}
+
+bool refreshLandmarks(Map *map, unsigned count)
+{
+    if (map->landmarks != NULL &&
+        map->landmarks->roadAdditions == map->roadAdditions)
+    {
+        return true;
+    }
+
+    return prepareLandmarks(map, count);
+}
+
+Route *landmarkDkstra(Map *map, unsigned routeId, City *start, City *finish)
+{
+    if (!refreshAdjacency(map)) return NULL;
+    Adjacency *graph = map->adjacency;
+
+    startNewSearch(map);
+    blockRouteCities(map, routeId);
+
+    touchCity(map, start);
+    touchCity(map, finish);
+    start->distance = 0;
+    start->visited = false;
+    finish->visited = false;
+
+    // paths of length INFINITY or more count as absent, as in relaxRoad
+    unsigned long long startBound = lowerBound(map->landmarks, start, finish);
+    if (startBound >= INFINITY) return NULL;
+    if (!pushOrDecrease(map->queue, start, startBound)) return NULL;
+
+    while (!isQueueEmpty(map->queue))
+    {
+        // a city with a bigger key cannot lie on any shortest path, so all
+        // cities needed to decide ambiguity have been visited
+        if (finish->visited && minKey(map->queue) > finish->distance) break;
+
+        City *actCity = popMin(map->queue);
+        actCity->visited = true;
+
+        for (uint32_t i = graph->offsets[actCity->id];
+             i < graph->ends[actCity->id]; ++i)
+        {
+            City *neighbour = map->cityById[graph->neighbours[i]];
+            touchCity(map, neighbour);
+            if (neighbour->visited) continue;
+
+            unsigned newDistance = addLength(actCity->distance,
+                                             graph->lengths[i]);
+            if (newDistance < neighbour->distance)
+            {
+                // also skips cities from which finish is unreachable
+                unsigned long long bound = lowerBound(map->landmarks, neighbour,
+                                                      finish);
+                if (bound >= INFINITY - newDistance) continue; // too long
+
+                neighbour->distance = newDistance;
+                if (!pushOrDecrease(map->queue, neighbour,
+                                    (unsigned long long) newDistance + bound))
+                {
+                    return NULL;
+                }
+            }
+        }
+    }
+
+    if (!finish->visited) return NULL;
+
+    // visiting order differs from dkstra, so ages and predecessors are
+    // decided afterwards over all shortest paths
+    if (!labelShortestPaths(map, start, finish)) return NULL;
+
+    return routeFromPrevious(map, start, finish);
+}
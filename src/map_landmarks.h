@@ -0,0 +1,82 @@
+/** @file
+ * Interfejs wyszukiwania dróg algorytmem A* z punktami orientacyjnymi (ALT)
+ *
+ * @author Filip Bieńkowski 407686
+ * @copyright Uniwersytet Warszawski
+ */
+
+#ifndef DROGI_MAP_LANDMARKS_H
+#define DROGI_MAP_LANDMARKS_H
+
+#include "map.h"
+
+/**
+ * @brief Liczba punktów orientacyjnych wyznaczanych w trybie
+ * SEARCH_LANDMARKS
+ */
+#define DEFAULT_LANDMARKS 8
+
+/**
+ * @brief Punkty orientacyjne wyznaczone dla mapy
+ */
+struct Landmarks
+{
+    /**
+     * @brief Liczba punktów orientacyjnych, a zarazem długość tablic
+     * landmarkDistances w miastach
+     */
+    unsigned count;
+
+    /**
+     * @brief Wartość licznika dodanych odcinków w chwili wyznaczenia punktów
+     */
+    unsigned long long roadAdditions;
+};
+typedef struct Landmarks Landmarks;
+
+/**
+ * @brief Sprawdza, czy punkty orientacyjne mogą być użyte do wyszukiwania
+ * Punkty są aktualne, jeśli od ich wyznaczenia nie dodano żadnego odcinka
+ * drogi, a oba miasta mają zapamiętane odległości. Usuwanie odcinków ich nie
+ * psuje: odległości w mniejszej sieci mogą tylko wzrosnąć, więc zapamiętane
+ * odległości nadal dają dolne ograniczenie zgodne z długościami odcinków.
+ * @param map -- wskaźnik na mapę
+ * @param start -- miasto początkowe
+ * @param finish -- miasto końcowe
+ * @return Wartość @p true jeśli tak, wartość @p false w przeciwnym wypadku
+ */
+bool landmarksAreFresh(Map *map, City *start, City *finish);
+
+/**
+ * @brief Wyznacza punkty orientacyjne, jeśli nie są aktualne
+ * Nie wolno jej wołać w trakcie usuwania odcinka, gdy odcinek jest tylko
+ * odłączony: punkty wyznaczone bez niego przestałyby być poprawne po jego
+ * przywróceniu.
+ * @param map -- wskaźnik na mapę
+ * @param count -- liczba punktów orientacyjnych
+ * @return Wartość @p true jeśli punkty są aktualne, wartość @p false jeśli
+ * mapa nie zawiera żadnego miasta lub nie udało się zaalokować pamięci
+ */
+bool refreshLandmarks(Map *map, unsigned count);
+
+/**
+ * @brief Wyszukiwanie najkrótszej drogi algorytmem A*
+ * Kolejność odwiedzania miast wyznacza suma odległości od początku i dolnego
+ * ograniczenia odległości do końca, wynikającego z nierówności trójkąta dla
+ * punktów orientacyjnych. Wyszukiwanie trwa, dopóki mogą istnieć inne
+ * najkrótsze drogi, więc wynik jest taki sam jak dla funkcji dkstra.
+ * @param map -- wskaźnik na mapę z aktualnymi punktami orientacyjnymi
+ * @param routeId -- numer drogi krajowej
+ * @param start -- miasto początkowe
+ * @param finish -- miasto końcowe
+ * @return Potencjalna droga krajowa, albo NULL jeśli nie ma drogi z A do B
+ */
+Route *landmarkDkstra(Map *map, unsigned routeId, City *start, City *finish);
+
+/**
+ * @brief Usuwa punkty orientacyjne i odległości zapamiętane w miastach
+ * @param map -- wskaźnik na mapę
+ */
+void removeLandmarks(Map *map);
+
+#endif //DROGI_MAP_LANDMARKS_H
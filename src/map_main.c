@@ -1,10 +1,87 @@
 #include "map_userInterface.h"
 
+#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
-int main()
+/**
+ * @brief Nazwa algorytmu wyszukiwania dróg, podawana w wierszu poleceń
+ */
+struct SearchModeName
 {
-  userReadInput(NULL);
+    const char *name; ///< nazwa podawana po opcji -s
+    SearchMode mode;  ///< wybierany algorytm
+};
 
-  return 0;
+/**
+ * @brief Algorytmy, które można wybrać opcją -s
+ */
+static const struct SearchModeName searchModeNames[] =
+{
+    {"dijkstra", SEARCH_DIJKSTRA},
+    {"bidirectional", SEARCH_BIDIRECTIONAL},
+    {"landmarks", SEARCH_LANDMARKS},
+    {"contraction", SEARCH_CONTRACTION},
+};
+
+/**
+ * @brief Znajduje algorytm wyszukiwania o podanej nazwie
+ * @param name - nazwa algorytmu
+ * @param mode - tu zapisywany jest znaleziony algorytm
+ * @return false, jeśli nie ma algorytmu o takiej nazwie; w przeciwnym
+ * wypadku true
+ */
+static bool parseSearchMode(const char *name, SearchMode *mode)
+{
+    size_t count = sizeof(searchModeNames) / sizeof(searchModeNames[0]);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (strcmp(searchModeNames[i].name, name) == 0)
+        {
+            *mode = searchModeNames[i].mode;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Wypisuje na standardowe wyjście diagnostyczne sposób wywołania
+ * @param program - nazwa programu
+ */
+static void printUsage(const char *program)
+{
+    size_t count = sizeof(searchModeNames) / sizeof(searchModeNames[0]);
+
+    fprintf(stderr, "Usage: %s [-s ", program);
+    for (size_t i = 0; i < count; ++i)
+    {
+        fprintf(stderr, i == 0 ? "%s" : "|%s", searchModeNames[i].name);
+    }
+    fprintf(stderr, "]\n");
+}
+
+int main(int argc, char *argv[])
+{
+    SearchMode mode = SEARCH_DIJKSTRA;
+
+    // the only option selects the route search algorithm
+    if (argc != 1 &&
+        (argc != 3 || strcmp(argv[1], "-s") != 0 ||
+         !parseSearchMode(argv[2], &mode)))
+    {
+        printUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    Map *map = newMap();
+    if (map == NULL) return EXIT_FAILURE;
+
+    setSearchMode(map, mode);
+    userReadInput(map);
+    deleteMap(map);
+
+    return 0;
 }
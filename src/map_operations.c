@@ -6,29 +6,40 @@
  */
 
 #include "map_operations.h"
+#include "map_bidirectional.h"
+#include "map_landmarks.h"
+#include "map_contraction.h"
+#include "map_adjacency.h"
 
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 
-static void markUnvisited(dNode *node)
+void resetSearchEpochs(Map *map)
 {
-    if (node != NULL)
+    for (uint32_t id = 0; id < map->cityCount; ++id)
     {
-        node->this->distance = INFINITY;
-        node->this->worstAge = YEAR_INFINTY;
-        node->this->visited = false;
-        node->this->previous = NULL;
-        markUnvisited(node->next);
+        map->cityById[id]->searchEpoch = 0;
     }
+
+    map->searchEpoch = 0;
 }
 
-static void markAllUnvisited(Dictionary *dictionary)
+void startNewSearch(Map *map)
 {
-    for (unsigned i = 0; i < HASHSIZE; ++i)
+    map->searchEpoch++;
+    map->blockedCities = NULL;
+
+    if (map->searchEpoch == 0)
     {
-        markUnvisited(dictionary->nodes[i]);
+        // counter wrapped around, so old stamps could look current again;
+        // this costs one pass over all cities every 2^32 searches
+        resetSearchEpochs(map);
+        map->searchEpoch++;
     }
+
+    clearQueue(map->queue);
+    clearQueue(map->queueBack);
 }
 
 static int min(int arg1, int arg2)
@@ -36,215 +47,406 @@ static int min(int arg1, int arg2)
     return arg1 < arg2 ? arg1 : arg2;
 }
 
-static void reverseArray(City **array, unsigned length)
+void blockRouteCities(Map *map, unsigned routeId)
 {
-    for (unsigned i = 0; i < (length / 2); ++i)
+    Route *route = lookupRoute(map->routes, routeId);
+
+    if (route != NULL)
     {
-        City *helper = array[length-1-i];
-        array[length-1-i] = array[i];
-        array[i] = helper;
+        if (route->positions == NULL)
+        {
+            route->positions = newCityPositions(route->howTheWayGoes,
+                                                route->length);
+        }
+        if (route->positions != NULL)
+        {
+            // touchCity() blocks the cities of the route as the search meets them
+            map->blockedCities = route->positions;
+            return;
+        }
+
+        // if we are extending an already existing route, then we must make sure
+        // it doesn`t cross itself
+        for (unsigned i = 0; i < route->length; ++i)
+        {
+            touchCity(map, route->howTheWayGoes[i]);
+            route->howTheWayGoes[i]->visited = true;
+            route->howTheWayGoes[i]->visitedBack = true;
+        }
     }
 }
 
-City *lowestDistanceNode(Map *map)
+bool relaxRoad(Map *map, City *actCity, City *neighbour, unsigned length,
+               int year)
 {
-    unsigned lowestDistance = INFINITY;
-    City *lowestNode = NULL;
+    unsigned newDistance = addLength(actCity->distance, length);
+    if (newDistance == INFINITY) return true; // too long, so no such path
 
-    for (int i = 0; i < HASHSIZE; ++i)
+    int newAge = min(actCity->worstAge, year);
+
+    if (newDistance < neighbour->distance)
+    {
+        neighbour->distance = newDistance;
+        neighbour->previous = actCity;
+        neighbour->worstAge = newAge;
+        return pushOrDecrease(map->queue, neighbour, newDistance);
+    }
+    else if (newDistance == neighbour->distance)
     {
-        for (dNode *current = map->cities->nodes[i];
-             current != NULL; current = current->next)
+        if (newAge > neighbour->worstAge)
         {
-            if (!current->this->visited) // we want unvisited node
-            {
-                if (current->this->distance < lowestDistance)
-                {
-                    lowestDistance = current->this->distance;
-                    lowestNode = current->this;
-                }
-            }
-
+            neighbour->distance = newDistance;
+            neighbour->previous = actCity;
+            neighbour->worstAge = newAge;
+        }
+        else if (newAge == neighbour->worstAge)
+        {
+            // we cannot decide how to get to this node, so this
+            // node is unreachable
+            neighbour->previous = NULL;
         }
     }
 
-    // if lowest distance is INFINTY then return NULL
-    return lowestNode;
+    return true;
 }
 
-bool thereAreUnvisitedNodes(Map *map)
+bool appendToSearchList(Map *map, City *city)
 {
-    for (unsigned i = 0; i < HASHSIZE; ++i)
+    if (map->searchListSize == map->searchListCapacity)
     {
-        dNode *current = map->cities->nodes[i];
-
-        while (current != NULL)
-        {
-            if (!current->this->visited)
-            {
-                return true;
-            }
-            else current = current->next;
-        }
+        unsigned newCapacity = map->searchListCapacity == 0
+                               ? 64 : 2 * map->searchListCapacity;
+        City **newArray = realloc(map->searchList,
+                                  sizeof(City *) * newCapacity);
+        if (newArray == NULL) return false;
+        map->searchList = newArray;
+        map->searchListCapacity = newCapacity;
     }
 
-    return false;
+    map->searchList[map->searchListSize++] = city;
+    return true;
 }
 
-Route *dkstra(Map *map, unsigned int routeId, City *start, City *finish)
+/**
+ * @brief Porównuje miasta według odległości od miasta początkowego
+ * @param first -- wskaźnik na wskaźnik na pierwsze miasto
+ * @param second -- wskaźnik na wskaźnik na drugie miasto
+ * @return Liczba ujemna, zero lub dodatnia, jak dla funkcji qsort
+ */
+static int compareDistance(const void *first, const void *second)
 {
-    // we make set of unvisited nodes
-    markAllUnvisited(map->cities);
+    unsigned distanceA = (*(City * const *) first)->distance;
+    unsigned distanceB = (*(City * const *) second)->distance;
 
-    if (map->routes[routeId] != NULL)
+    return (distanceA > distanceB) - (distanceA < distanceB);
+}
+
+bool labelShortestPaths(Map *map, City *start, City *finish)
+{
+    Adjacency *graph = map->adjacency;
+    map->searchListSize = 0;
+    finish->onShortestPath = true;
+    if (!appendToSearchList(map, finish)) return false;
+
+    // collect every city lying on some shortest path from start to finish,
+    // going back over roads on which the distance grows by the road length
+    for (unsigned i = 0; i < map->searchListSize; ++i)
     {
-        // if we are extending an already existing route, then we must make sure
-        // it doesn`t cross itself
-        for (unsigned i = 0; i < map->routes[routeId]->length; ++i)
+        City *city = map->searchList[i];
+
+        for (uint32_t j = graph->offsets[city->id];
+             j < graph->ends[city->id]; ++j)
         {
-            map->routes[routeId]->howTheWayGoes[i]->visited = true;
+            City *neighbour = map->cityById[graph->neighbours[j]];
+            touchCity(map, neighbour);
+
+            if (!neighbour->onShortestPath && neighbour->visited &&
+                neighbour->distance != INFINITY &&
+                (unsigned long long) neighbour->distance +
+                graph->lengths[j] == city->distance)
+            {
+                neighbour->onShortestPath = true;
+                if (!appendToSearchList(map, neighbour)) return false;
+            }
         }
     }
 
-    // distance is 0 for starting node
-    start->distance = 0;
-    start->visited = false;
-    finish->visited = false;
+    // now relax them in the order of dkstra, so that predecessors and
+    // ambiguity are decided exactly as there
+    qsort(map->searchList, map->searchListSize, sizeof(City *),
+          compareDistance);
 
-    while (thereAreUnvisitedNodes(map))
+    for (unsigned i = 0; i < map->searchListSize; ++i)
     {
-        City *actCity = lowestDistanceNode(map);
-        if (actCity == NULL) return NULL; // no path from start to finish
-        actCity->visited = true; // remove node from unvisited set
-        if (actCity == finish) break; // we found the way so we are done
-
-        for (RoadList *actRoad = actCity->roads;
-             actRoad != NULL; actRoad = actRoad->next) // check each neighbour
+        City *city = map->searchList[i];
+        city->worstAge = YEAR_INFINTY;
+        city->previous = NULL;
+        if (city == start) continue;
+
+        bool reached = false;
+        for (uint32_t j = graph->offsets[city->id];
+             j < graph->ends[city->id]; ++j)
         {
-            City *neighbour =
-                    actRoad->this->cityA == actCity ? actRoad->this->cityB
-                                                    : actRoad->this->cityA;
+            City *neighbour = map->cityById[graph->neighbours[j]];
 
-            if (!neighbour->visited) // only check unvisited nodes
+            if (!neighbour->onShortestPath ||
+                (unsigned long long) neighbour->distance +
+                graph->lengths[j] != city->distance)
             {
-                unsigned newDistance =
-                        actCity->distance + actRoad->this->length;
-                int newAge = min(actCity->worstAge, actRoad->this->year);
+                continue;
+            }
 
-                if (newDistance < neighbour->distance)
-                {
-                    neighbour->distance = newDistance;
-                    neighbour->previous = actCity;
-                    neighbour->worstAge = newAge;
-                }
-                else if (newDistance == neighbour->distance)
-                {
-                    if (newAge > neighbour->worstAge)
-                    {
-                        neighbour->distance = newDistance;
-                        neighbour->previous = actCity;
-                        neighbour->worstAge = newAge;
-                    }
-                    else if (newAge == neighbour->worstAge)
-                    {
-                        // we cannot decide how to get to this node, so this
-                        // node is unreachable
-                        neighbour->previous = NULL;
-                    }
-                }
+            int newAge = min(neighbour->worstAge, graph->years[j]);
+            if (!reached || newAge > city->worstAge)
+            {
+                reached = true;
+                city->worstAge = newAge;
+                city->previous = neighbour;
+            }
+            else if (newAge == city->worstAge)
+            {
+                // same rule as in relaxRoad
+                city->previous = NULL;
             }
         }
     }
 
+    return true;
+}
+
+Route *routeFromPrevious(Map *map, City *start, City *finish)
+{
     // there is no path; if it`s not NULL then there must be some way from
     // start to finish, because otherwise it would not be assigned
     if (finish->previous == NULL) return NULL;
 
+    // measure the path first, so that its cities take a single allocation
+    unsigned length = 0;
+    for (City *act = finish; act != NULL; act = act->previous)
+    {
+        if (act->previous == NULL && act != start) return NULL;
+        length++;
+    }
+
     // we must now make new route out of our shortest path
     Route *newRoute = malloc(sizeof(Route));
     if (newRoute == NULL) return NULL;
-    newRoute->length = 0;
-
-    newRoute->howTheWayGoes = malloc(sizeof(City *) * newRoute->length);
 
-    for (City *act = finish; act != NULL; act = act->previous)
+    newRoute->howTheWayGoes = malloc(sizeof(City *) * length);
+    newRoute->roads = malloc(sizeof(Road *) * length);
+    newRoute->positions = NULL;
+    newRoute->description = NULL;
+    if (newRoute->howTheWayGoes == NULL || newRoute->roads == NULL)
     {
-        if (act->previous == NULL && act != start)
-        {
-            free(newRoute->howTheWayGoes);
-            free(newRoute);
-            return NULL;
-        }
+        freeRoute(newRoute);
+        return NULL;
+    }
+    newRoute->length = length;
+    newRoute->capacity = length;
 
-        newRoute->length++;
-        City **failInsurance = newRoute->howTheWayGoes; // in case realloc fails
-        newRoute->howTheWayGoes = realloc(newRoute->howTheWayGoes,
-                                          sizeof(City *) * newRoute->length);
-        if (newRoute->howTheWayGoes == NULL)
-        {
-            free(failInsurance);
-            free(newRoute);
-            return NULL;
-        }
-        newRoute->howTheWayGoes[newRoute->length - 1] = act;
+    // previous pointers lead from the finish back, so we fill from the end
+    newRoute->howTheWayGoes[--length] = finish;
+    for (City *act = finish; act->previous != NULL; act = act->previous)
+    {
+        --length;
+        newRoute->howTheWayGoes[length] = act->previous;
+        newRoute->roads[length] = findRoadBetween(map, act->previous, act);
     }
 
-    reverseArray(newRoute->howTheWayGoes, newRoute->length);
     return newRoute;
 }
 
-Road *findRoadBetween(City *start, City *finish)
+void freeRoute(Route *route)
+{
+    if (route != NULL)
+    {
+        removeCityPositions(route->positions);
+        free(route->description);
+        free(route->howTheWayGoes);
+        free(route->roads);
+        free(route);
+    }
+}
+
+bool reserveRouteCities(Route *route, unsigned needed)
 {
-    for (RoadList *act = start->roads; act != NULL ; act = act->next)
+    if (needed <= route->capacity) return true;
+
+    // doubling keeps appending city by city linear in total
+    unsigned newCapacity = route->capacity < 4 ? 4 : route->capacity;
+    while (newCapacity < needed)
     {
-        if (act->this->cityA == finish || act->this->cityB == finish)
+        newCapacity = newCapacity > UINT_MAX / 2 ? needed : 2 * newCapacity;
+    }
+
+    City **newCities = realloc(route->howTheWayGoes,
+                               sizeof(City *) * newCapacity);
+    if (newCities == NULL) return false;
+    route->howTheWayGoes = newCities;
+
+    // the capacity changes only once both arrays are big enough
+    Road **newRoads = realloc(route->roads, sizeof(Road *) * newCapacity);
+    if (newRoads == NULL) return false;
+    route->roads = newRoads;
+
+    route->capacity = newCapacity;
+    return true;
+}
+
+Route *dkstra(Map *map, unsigned int routeId, City *start, City *finish)
+{
+    if (!refreshAdjacency(map)) return NULL;
+    Adjacency *graph = map->adjacency;
+
+    // every city not stamped by this search counts as unvisited
+    startNewSearch(map);
+    blockRouteCities(map, routeId);
+
+    // distance is 0 for starting node
+    touchCity(map, start);
+    touchCity(map, finish);
+    start->distance = 0;
+    start->visited = false;
+    finish->visited = false;
+
+    // the queue holds only reached nodes, so it runs empty when there is no
+    // path from start to finish
+    if (!pushOrDecrease(map->queue, start, start->distance)) return NULL;
+
+    while (!isQueueEmpty(map->queue))
+    {
+        City *actCity = popMin(map->queue);
+        actCity->visited = true; // remove node from unvisited set
+        if (actCity == finish) break; // we found the way so we are done
+
+        for (uint32_t i = graph->offsets[actCity->id];
+             i < graph->ends[actCity->id]; ++i) // check each neighbour
         {
-            return act->this;
+            City *neighbour = map->cityById[graph->neighbours[i]];
+            touchCity(map, neighbour);
+
+            if (!neighbour->visited) // only check unvisited nodes
+            {
+                if (!relaxRoad(map, actCity, neighbour, graph->lengths[i],
+                               graph->years[i]))
+                {
+                    return NULL;
+                }
+            }
         }
     }
 
-    return NULL;
+    return routeFromPrevious(map, start, finish);
 }
 
-void removeFromRoadList(Road *pRoad, City *pCity)
+void prepareSearch(Map *map, unsigned routeId)
 {
-    if (pCity->roads->this == pRoad)
+    if (map->searchMode == SEARCH_LANDMARKS)
     {
-        RoadList *removed = pCity->roads;
-        pCity->roads = pCity->roads->next;
-        free(removed);
+        refreshLandmarks(map, DEFAULT_LANDMARKS);
     }
-    else
+    // findRoute uses the hierarchy only for new routes
+    else if (map->searchMode == SEARCH_CONTRACTION &&
+             lookupRoute(map->routes, routeId) == NULL)
     {
-        RoadList *act = pCity->roads->next;
-        RoadList *previous = pCity->roads;
-        while (act->this != pRoad)
-        {
-            previous = act;
-            act = act->next;
-        }
-        previous->next = act->next;
-        free(act);
+        refreshContractionHierarchy(map);
+    }
+}
+
+Route *findRoute(Map *map, unsigned routeId, City *start, City *finish)
+{
+    // the hierarchy cannot avoid cities, so it is used only for new routes
+    if (lookupRoute(map->routes, routeId) == NULL &&
+        hierarchyIsFresh(map, start, finish))
+    {
+        return hierarchyDkstra(map, start, finish);
     }
+
+    if (landmarksAreFresh(map, start, finish))
+    {
+        return landmarkDkstra(map, routeId, start, finish);
+    }
+
+    if (map->searchMode == SEARCH_BIDIRECTIONAL)
+    {
+        return bidirectionalDkstra(map, routeId, start, finish);
+    }
+
+    return dkstra(map, routeId, start, finish);
+}
+
+Road *findRoadBetween(Map *map, City *start, City *finish)
+{
+    return lookupRoad(map->roadIndex, start->id, finish->id);
 }
 
-City *makeNewCity(Map *map, const char *name)
+/**
+ * @brief Usuwa z tablicy odcinków miasta i z migawki sąsiedztwa odcinek
+ * z podanej pozycji
+ * @param map -- wskaźnik na mapę
+ * @param city -- miasto
+ * @param index -- pozycja usuwanego odcinka
+ */
+static void removeRoadAt(Map *map, City *city, unsigned index)
+{
+    removeEdgeAt(map, city, index);
+
+    unsigned last = --city->roadsCount;
+    Road *moved = city->roads[last];
+    city->roads[index] = moved;
+
+    // a road from the city to itself sits in the array twice, so the
+    // moved slot is found by its position, not only by its end
+    if (moved->cityA == city && moved->indexA == last) moved->indexA = index;
+    else moved->indexB = index;
+}
+
+void detachRoad(Map *map, Road *pRoad)
 {
-    City *newCity = malloc(sizeof(City));
+    eraseRoad(map->roadIndex, pRoad);
+    removeRoadAt(map, pRoad->cityA, pRoad->indexA);
+    removeRoadAt(map, pRoad->cityB, pRoad->indexB);
+    graphChanged(map);
+}
+
+City *makeNewCity(Map *map, const char *name, uint64_t hash)
+{
+    City *newCity = poolAlloc(map->cityPool);
 
     if (newCity != NULL)
     {
-        newCity->name = malloc(sizeof(char) * (strlen(name) + 1));
-        if (newCity->name == NULL)
+        if (map->cityCount == map->cityByIdCapacity)
         {
-            free(newCity);
+            uint32_t newCapacity = map->cityByIdCapacity == 0
+                                   ? 64 : 2 * map->cityByIdCapacity;
+            City **newArray = realloc(map->cityById,
+                                      sizeof(City *) * newCapacity);
+            if (newArray == NULL)
+            {
+                poolFree(map->cityPool, newCity);
+                return NULL;
+            }
+            map->cityById = newArray;
+            map->cityByIdCapacity = newCapacity;
+        }
+
+        // on failure below the copy stays in the arena until deleteMap
+        newCity->name = storeString(map->names, name);
+        if (newCity->name == NULL || !putHashed(map->cities, newCity, hash))
+        {
+            poolFree(map->cityPool, newCity);
             return NULL;
         }
 
-        strcpy(newCity->name, name);
+        newCity->id = map->cityCount;
+        map->cityById[map->cityCount++] = newCity;
         newCity->roads = NULL;
+        newCity->roadsCount = 0;
+        newCity->roadsCapacity = 0;
+        newCity->searchEpoch = 0;
+        newCity->landmarkDistances = NULL;
+        newCity->hierarchyRank = NOT_RANKED;
 
-        put(map->cities, newCity);
         return newCity;
     }
     else
@@ -254,35 +456,28 @@ City *makeNewCity(Map *map, const char *name)
 
 }
 
-bool makeNewRoad(City *cityA, City *cityB, unsigned length, int builtYear)
+bool makeNewRoad(Map *map, City *cityA, City *cityB, unsigned length,
+                 int builtYear)
 {
-    RoadList *newNodeA = malloc(sizeof(RoadList));
-    RoadList *newNodeB = malloc(sizeof(RoadList));
-    Road *road;
-    if (newNodeA != NULL && newNodeB != NULL)
-    {
-        newNodeA->next = newNodeB->next = NULL;
-        road = newNodeA->this = newNodeB->this = malloc(sizeof(Road));
-        if (newNodeA->this != NULL)
-        {
-            road->cityA = cityA;
-            road->cityB = cityB;
-            road->length = length;
-            road->year = builtYear;
-            road->queued = false;
-            addToRoadList(cityA, newNodeA);
-            addToRoadList(cityB, newNodeB);
-            return true;
-        }
-        else
-        {
-            return false;
-        }
-    }
-    else
+    Road *road = poolAlloc(map->roadPool);
+    if (road == NULL) return false;
+
+    road->cityA = cityA;
+    road->cityB = cityB;
+    road->length = length;
+    road->year = builtYear;
+    road->routes = NULL;
+    road->routesCount = 0;
+    road->routesCapacity = 0;
+
+    if (!attachRoad(map, road))
     {
+        poolFree(map->roadPool, road);
         return false;
     }
+
+    map->roadAdditions++;
+    return true;
 }
 
 City *findCity(Map *map, const char *cityName)
@@ -290,6 +485,11 @@ City *findCity(Map *map, const char *cityName)
     return get(map->cities, cityName);
 }
 
+City *findCityHashed(Map *map, const char *cityName, uint64_t hash)
+{
+    return getHashed(map->cities, cityName, hash);
+}
+
 bool isCorrectName(const char *name)
 {
     unsigned i = 0;
@@ -315,27 +515,52 @@ bool isCorrectName(const char *name)
     return true;
 }
 
-void addToRoadList(City *whereRoad, RoadList *addedRoad)
+/**
+ * @brief Dopisuje odcinek na koniec tablicy odcinków miasta i migawki
+ * sąsiedztwa
+ * @param map -- wskaźnik na mapę
+ * @param city -- miasto
+ * @param road -- odcinek drogi
+ * @param index -- pole odcinka, w którym zapamiętujemy jego pozycję
+ * @return false, jeśli nie udało się zaalokować pamięci; w przeciwnym wypadku true
+ */
+static bool appendRoad(Map *map, City *city, Road *road, unsigned *index)
 {
-    RoadList *current = whereRoad->roads;
-
-    if (current == NULL)
+    if (city->roadsCount == city->roadsCapacity)
     {
-        whereRoad->roads = addedRoad;
+        unsigned newCapacity = city->roadsCapacity == 0
+                               ? 4 : 2 * city->roadsCapacity;
+        Road **newArray = realloc(city->roads, sizeof(Road *) * newCapacity);
+        if (newArray == NULL) return false;
+        city->roads = newArray;
+        city->roadsCapacity = newCapacity;
     }
 
-    else
+    *index = city->roadsCount;
+    city->roads[city->roadsCount++] = road;
+    appendEdge(map, city);
+    return true;
+}
+
+bool attachRoad(Map *map, Road *addedRoad)
+{
+    if (!insertRoad(map->roadIndex, addedRoad)) return false;
+
+    if (!appendRoad(map, addedRoad->cityA, addedRoad, &addedRoad->indexA))
     {
-        RoadList *previous = current;
-        while (current != NULL)
-        {
-            previous = current;
-            current = current->next;
-        }
+        eraseRoad(map->roadIndex, addedRoad);
+        return false;
+    }
 
-        previous->next = addedRoad;
-        addedRoad->next = NULL;
+    if (!appendRoad(map, addedRoad->cityB, addedRoad, &addedRoad->indexB))
+    {
+        removeRoadAt(map, addedRoad->cityA, addedRoad->indexA);
+        eraseRoad(map->roadIndex, addedRoad);
+        return false;
     }
+
+    graphChanged(map);
+    return true;
 }
 
 Road *findRoadBetweenCities(Map *map, const char *city1, const char *city2)
@@ -348,154 +573,385 @@ Road *findRoadBetweenCities(Map *map, const char *city1, const char *city2)
         return NULL;
     }
 
-    RoadList *act = first->roads;
+    return findRoadBetween(map, first, second);
+}
 
-    while (act != NULL)
+unsigned findCityIndex(Route *route, City *cityToFind)
+{
+    if (route->positions == NULL)
     {
-        if (act->this->cityA == second || act->this->cityB == second)
-        {
-            return act->this;
-        }
-        else
+        route->positions = newCityPositions(route->howTheWayGoes,
+                                            route->length);
+    }
+    if (route->positions != NULL)
+    {
+        return findCityPosition(route->positions, cityToFind);
+    }
+
+    // no memory for the index, fall back to scanning the route
+    for (unsigned i = 0; i < route->length; ++i)
+    {
+        if (route->howTheWayGoes[i] == cityToFind)
         {
-            act = act->next;
+            return i;
         }
     }
 
-    return NULL;
+    return INFINITY;
 }
 
-bool hasCities(Route *route, City *cityA, City *cityB)
+void indexRouteTail(Route *route, unsigned from)
 {
-    if (route == NULL) return false;
-    bool cityAOK = false;
-    bool cityBOK = false;
+    if (route->positions == NULL) return;
 
-    for (unsigned i = 0; i < route->length; ++i)
+    for (unsigned i = from; i < route->length; ++i)
     {
-        if (!cityAOK)
+        if (!addCityPosition(route->positions, route->howTheWayGoes[i], i))
         {
-            if (route->howTheWayGoes[i] == cityA)
-            {
-                cityAOK = true;
-            }
+            removeCityPositions(route->positions);
+            route->positions = NULL;
+            return;
         }
-        if (!cityBOK)
-        {
-            if (route->howTheWayGoes[i] == cityB)
-            {
-                cityBOK = true;
-            }
-        }
-        if (cityAOK && cityBOK)
+    }
+}
+
+void insertIntoRoute(Route *target, Route *source, unsigned from, unsigned to)
+{
+    if (from > to)
+    {
+        unsigned helper = to;
+        to = from;
+        from = helper;
+    }
+
+    // positions behind the insertion move, so the index is rebuilt on demand
+    removeCityPositions(target->positions);
+    target->positions = NULL;
+    forgetDescription(target);
+
+    unsigned oldLength = target->length;
+    unsigned shift = source->length - 2; // [from] and [to] are the same so -2
+    target->length += shift;
+
+    // we must move elements behind the inserted part, cities and roads alike
+    memmove(target->howTheWayGoes + to + shift, target->howTheWayGoes + to,
+            sizeof(City *) * (oldLength - to));
+    memmove(target->roads + to + shift, target->roads + to,
+            sizeof(Road *) * (oldLength - 1 - to));
+
+    memcpy(target->howTheWayGoes + from, source->howTheWayGoes,
+           sizeof(City *) * source->length);
+    memcpy(target->roads + from, source->roads,
+           sizeof(Road *) * (source->length - 1));
+}
+
+/**
+ * @brief Dopisuje drogę krajową do listy dróg przechodzących przez odcinek
+ * @param road -- odcinek
+ * @param route -- droga krajowa
+ * @return false, jeśli nie udało się zaalokować pamięci; w przeciwnym wypadku true
+ */
+static bool appendRouteToRoad(Road *road, Route *route)
+{
+    if (road->routesCount == road->routesCapacity)
+    {
+        unsigned newCapacity = road->routesCapacity == 0
+                               ? 2 : 2 * road->routesCapacity;
+        Route **newRoutes = realloc(road->routes,
+                                    sizeof(Route *) * newCapacity);
+        if (newRoutes == NULL) return false;
+
+        road->routes = newRoutes;
+        road->routesCapacity = newCapacity;
+    }
+
+    road->routes[road->routesCount++] = route;
+    return true;
+}
+
+/**
+ * @brief Wykreśla jedno wystąpienie drogi krajowej z listy dróg odcinka
+ * @param road -- odcinek
+ * @param route -- droga krajowa znajdująca się na liście
+ */
+static void removeRouteFromRoad(Road *road, Route *route)
+{
+    for (unsigned i = 0; i < road->routesCount; ++i)
+    {
+        if (road->routes[i] == route)
         {
-            return true;
+            road->routes[i] = road->routes[--road->routesCount];
+            return;
         }
     }
-
-    return false;
 }
 
-unsigned findCityIndex(Route *route, City *cityToFind)
+bool linkRouteSegments(Route *route, Road **roads, unsigned count)
 {
-    for (unsigned i = 0; i < route->length; ++i)
+    for (unsigned i = 0; i < count; ++i)
     {
-        if (route->howTheWayGoes[i] == cityToFind)
+        if (!appendRouteToRoad(roads[i], route))
         {
-            return i;
+            unlinkRouteSegments(route, roads, i);
+            return false;
         }
     }
 
-    return INFINITY;
+    return true;
 }
 
-void insertIntoRoute(Route *target, Route *source, unsigned from, unsigned to)
+void unlinkRouteSegments(Route *route, Road **roads, unsigned count)
 {
-    if (from > to)
+    for (unsigned i = 0; i < count; ++i)
     {
-        unsigned helper = to;
-        to = from;
-        from = helper;
+        removeRouteFromRoad(roads[i], route);
     }
+}
 
-    unsigned oldLength = target->length;
-    target->length += (source->length - 2);// [from] and [to] are the same so -2
-    target->howTheWayGoes = realloc(target->howTheWayGoes, sizeof(City *) *
-                                                           target->length);
+/**
+ * @brief Znajduje miejsce, w którym droga krajowa przechodzi przez odcinek
+ * @param route -- droga krajowa
+ * @param road -- odcinek
+ * @param uses -- tu zapisywana jest liczba przejść drogi przez odcinek
+ * @return Indeks miasta, od którego zaczyna się pierwsze przejście
+ */
+static unsigned findRoadPosition(Route *route, Road *road, unsigned *uses)
+{
+    unsigned position = INFINITY;
+    *uses = 0;
 
-    // we must move elements in array
-    unsigned h = 0;
-    for (unsigned i = oldLength-1; i >= to; i--)
+    for (unsigned i = 0; i + 1 < route->length; ++i)
     {
-        ++h;
-        target->howTheWayGoes[target->length-h] = target->howTheWayGoes[i];
-        target->howTheWayGoes[i] = NULL;
+        if (route->roads[i] == road)
+        {
+            if (*uses == 0) position = i;
+            ++*uses;
+        }
     }
 
-    unsigned j = from;
-    for (unsigned k = 0; k < source->length; ++k)
+    return position;
+}
+
+/**
+ * @brief Usuwa tablicę wyznaczonych zastępczych fragmentów dróg krajowych
+ * @param potentialNewRoutes -- tablica fragmentów, z pozycjami równymi NULL
+ * @param count -- rozmiar tablicy
+ */
+static void freePotentialRoutes(Route **potentialNewRoutes, unsigned count)
+{
+    for (unsigned i = 0; i < count; ++i)
     {
-        target->howTheWayGoes[j] = source->howTheWayGoes[k];
-        ++j;
+        freeRoute(potentialNewRoutes[i]);
     }
+    free(potentialNewRoutes);
 }
 
-bool checkRoutesAfterRoadRemoval(Map *map, City *cityA, City *cityB)
+bool checkRoutesAfterRoadRemoval(Map *map, Road *road)
 {
     // returned true means it`s ok to remove this road and updates routes,
     // false means it`s not ok and doesn`t change anything
 
-    Route *potentialNewRoutes[ROUTES_AMOUNT];
+    unsigned count = road->routesCount;
+    if (count == 0) return true;
 
-    for (int i = 0; i < ROUTES_AMOUNT; ++i)
+    // potentialNewRoutes[i] replaces the road in road->routes[i]
+    Route **potentialNewRoutes = calloc(count, sizeof(Route *));
+    unsigned *positions = malloc(sizeof(unsigned) * count);
+    if (potentialNewRoutes == NULL || positions == NULL)
     {
-        potentialNewRoutes[i] = NULL;
+        free(potentialNewRoutes);
+        free(positions);
+        return false;
     }
 
-    unsigned requiredSize = 0;
-    for (int j = 0; j < ROUTES_AMOUNT; ++j)
+    bool success = true;
+    for (unsigned j = 0; success && j < count; ++j)
     {
-        if (hasCities(map->routes[j], cityA, cityB))
-        {
-            unsigned start = findCityIndex(map->routes[j], cityA);
-            unsigned finish = findCityIndex(map->routes[j], cityB);
-            if (finish < start)
-            {
-                unsigned helper = start;
-                start = finish;
-                finish = helper;
-            }
+        Route *route = road->routes[j];
+        unsigned uses;
+        positions[j] = findRoadPosition(route, road, &uses);
 
-            potentialNewRoutes[j] = dkstra(map, j,
-                                           map->routes[j]->howTheWayGoes[start],
-                                           map->routes[j]->howTheWayGoes[finish]);
-            if (potentialNewRoutes[j] == NULL) return false;
-            requiredSize += potentialNewRoutes[j]->length;
+        // one detour can not replace two passes through the same road
+        if (uses > 1)
+        {
+            success = false;
+        }
+        else
+        {
+            City *from = route->howTheWayGoes[positions[j]];
+            City *to = route->howTheWayGoes[positions[j] + 1];
+            potentialNewRoutes[j] = findRoute(map, route->id, from, to);
+            if (potentialNewRoutes[j] == NULL) success = false;
         }
     }
 
-    City **memoryCheck = malloc(sizeof(City *) * requiredSize);
-    if (memoryCheck == NULL) return false;
-    free(memoryCheck);
+    // room for every detour is reserved up front; a failure leaves only
+    // some spare capacity behind
+    for (unsigned j = 0; success && j < count; ++j)
+    {
+        if (!reserveRouteCities(road->routes[j], road->routes[j]->length +
+                                                 potentialNewRoutes[j]->length - 2))
+        {
+            success = false;
+        }
+    }
 
-    for (int k = 0; k < ROUTES_AMOUNT; ++k)
+    // detours are linked first, so that running out of memory changes nothing
+    unsigned linked = 0;
+    while (success && linked < count)
     {
-        if (potentialNewRoutes[k] != NULL)
+        if (linkRouteSegments(road->routes[linked],
+                              potentialNewRoutes[linked]->roads,
+                              potentialNewRoutes[linked]->length - 1))
         {
-            insertIntoRoute(map->routes[k], potentialNewRoutes[k],
-                            findCityIndex(map->routes[k], cityA),
-                            findCityIndex(map->routes[k], cityB));
+            ++linked;
+        }
+        else
+        {
+            success = false;
         }
     }
 
-    for (int i = 0; i < ROUTES_AMOUNT; ++i)
+    if (!success)
     {
-        if (potentialNewRoutes[i] != NULL)
+        for (unsigned k = 0; k < linked; ++k)
         {
-            free(potentialNewRoutes[i]->howTheWayGoes);
-            free(potentialNewRoutes[i]);
+            unlinkRouteSegments(road->routes[k], potentialNewRoutes[k]->roads,
+                                potentialNewRoutes[k]->length - 1);
         }
+        freePotentialRoutes(potentialNewRoutes, count);
+        free(positions);
+        return false;
     }
 
+    for (unsigned k = 0; k < count; ++k)
+    {
+        insertIntoRoute(road->routes[k], potentialNewRoutes[k],
+                        positions[k], positions[k] + 1);
+    }
+    // no route passes through the removed road any more
+    road->routesCount = 0;
+
+    freePotentialRoutes(potentialNewRoutes, count);
+    free(positions);
     return true;
 }
+
+/**
+ * @brief Liczy cyfry zapisu dziesiętnego liczby
+ * @param value -- liczba
+ * @return Liczba cyfr
+ */
+static unsigned decimalLength(unsigned value)
+{
+    unsigned length = 1;
+    for (; value >= 10; value /= 10) ++length;
+    return length;
+}
+
+/**
+ * @brief Liczy znaki zapisu dziesiętnego liczby ze znakiem
+ * @param value -- liczba
+ * @return Liczba znaków, wliczając minus
+ */
+static unsigned signedDecimalLength(int value)
+{
+    // 0u - value is the magnitude even for INT_MIN
+    return value < 0 ? 1 + decimalLength(0u - (unsigned) value)
+                     : decimalLength((unsigned) value);
+}
+
+/**
+ * @brief Zapisuje liczbę dziesiętnie, bez kończącego zera
+ * @param destination -- miejsce na zapis
+ * @param value -- liczba
+ * @return Wskaźnik na znak za zapisaną liczbą
+ */
+static char *writeUnsigned(char *destination, unsigned value)
+{
+    char *end = destination + decimalLength(value);
+
+    // digits come out from the least significant one
+    char *act = end;
+    do
+    {
+        *--act = (char) ('0' + value % 10);
+        value /= 10;
+    } while (value != 0);
+
+    return end;
+}
+
+/**
+ * @brief Zapisuje liczbę ze znakiem dziesiętnie, bez kończącego zera
+ * @param destination -- miejsce na zapis
+ * @param value -- liczba
+ * @return Wskaźnik na znak za zapisaną liczbą
+ */
+static char *writeSigned(char *destination, int value)
+{
+    if (value < 0)
+    {
+        *destination++ = '-';
+        return writeUnsigned(destination, 0u - (unsigned) value);
+    }
+
+    return writeUnsigned(destination, (unsigned) value);
+}
+
+char *describeRoute(Route *route, size_t *length)
+{
+    // the exact size is known up front, so the text takes one allocation
+    size_t size = decimalLength(route->id) + 1; // +1 for the null character
+    for (unsigned i = 0; i < route->length; ++i)
+    {
+        size += 1 + strlen(route->howTheWayGoes[i]->name);
+    }
+    for (unsigned i = 0; i + 1 < route->length; ++i)
+    {
+        size += 2 + decimalLength(route->roads[i]->length) +
+                signedDecimalLength(route->roads[i]->year);
+    }
+
+    char *description = malloc(sizeof(char) * size);
+    if (description == NULL) return NULL;
+
+    char *act = writeUnsigned(description, route->id);
+    for (unsigned i = 0; i < route->length; ++i)
+    {
+        const char *name = route->howTheWayGoes[i]->name;
+        size_t nameLength = strlen(name);
+
+        *act++ = ';';
+        memcpy(act, name, nameLength);
+        act += nameLength;
+
+        if (i + 1 < route->length)
+        {
+            *act++ = ';';
+            act = writeUnsigned(act, route->roads[i]->length);
+            *act++ = ';';
+            act = writeSigned(act, route->roads[i]->year);
+        }
+    }
+    *act = '\0';
+
+    *length = size - 1;
+    return description;
+}
+
+const char *cachedDescription(Route *route)
+{
+    if (route->description == NULL)
+    {
+        route->description = describeRoute(route, &route->descriptionLength);
+    }
+
+    return route->description;
+}
+
+void forgetDescription(Route *route)
+{
+    free(route->description);
+    route->description = NULL;
+}
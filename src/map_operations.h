@@ -10,16 +10,79 @@
 
 #include "map.h"
 
-#define CHAR_BUFFER 4096
 #define INFINITY UINT_MAX
 #define YEAR_INFINTY INT_MAX
 
 /**
- * @brief Dodaje nowy węzeł odcinka drogowego do listy odcinków w podanym mieście.
- * @param whereRoad -- miasto
- * @param addedRoad -- węzeł listy odcinków drogowych
+ * @brief Dodaje długość odcinka do odległości miasta.
+ * Suma jest liczona bez przepełnienia. Drogi o długości co najmniej INFINITY
+ * nie mieszczą się w odległości miasta, więc traktujemy je jak nieistniejące.
+ * @param distance -- odległość miasta, mniejsza niż INFINITY
+ * @param length -- długość odcinka
+ * @return Suma, lub INFINITY jeśli nie jest mniejsza niż INFINITY
  */
-void addToRoadList(City *whereRoad, RoadList *addedRoad);
+static inline unsigned addLength(unsigned distance, unsigned length)
+{
+    unsigned long long sum = (unsigned long long) distance + length;
+    return sum < INFINITY ? (unsigned) sum : INFINITY;
+}
+
+/**
+ * @brief Przygotowuje pola miasta do użycia przez bieżące wyszukiwanie.
+ * Jeśli miasto nie było jeszcze odwiedzone w bieżącym wyszukiwaniu, to jego
+ * pola używane przez algorytm djkstry są ustawiane na wartości początkowe
+ * (nieskończona odległość, nieodwiedzone). Dzięki temu przygotowanie
+ * wyszukiwania nie wymaga przejścia po wszystkich miastach.
+ * @param map -- wskaźnik na mapę
+ * @param city -- wskaźnik na miasto
+ */
+static inline void touchCity(Map *map, City *city)
+{
+    if (city->searchEpoch != map->searchEpoch)
+    {
+        // cities of the route being extended count as visited both ways
+        bool blocked = map->blockedCities != NULL &&
+                       findCityPosition(map->blockedCities, city) != INFINITY;
+
+        city->searchEpoch = map->searchEpoch;
+        city->distance = INFINITY;
+        city->worstAge = YEAR_INFINTY;
+        city->visited = blocked;
+        city->previous = NULL;
+        city->distanceBack = INFINITY;
+        city->visitedBack = blocked;
+        city->onShortestPath = false;
+        city->queueIndex[FORWARD_QUEUE] = NOT_QUEUED;
+        city->queueIndex[BACKWARD_QUEUE] = NOT_QUEUED;
+    }
+}
+
+/**
+ * @brief Rozpoczyna nowe wyszukiwanie.
+ * Zwiększa numer bieżącego wyszukiwania, przez co pola wszystkich miast
+ * używane przez algorytm djkstry stają się nieaktualne, oraz opróżnia kolejkę.
+ * @param map -- wskaźnik na mapę
+ */
+void startNewSearch(Map *map);
+
+/**
+ * @brief Zeruje numery wyszukiwań we wszystkich miastach.
+ * Używane, gdy licznik wyszukiwań się przepełni.
+ * @param map -- wskaźnik na mapę
+ */
+void resetSearchEpochs(Map *map);
+
+/**
+ * @brief Dopisuje odcinek drogowy na koniec tablic odcinków obu jego końców
+ * i dodaje go do indeksu odcinków mapy.
+ * Zapamiętuje w odcinku jego pozycje w tablicach, aby można go było usunąć
+ * w czasie stałym. Poprawia migawkę sąsiedztwa i zwiększa licznik zmian
+ * sieci dróg.
+ * @param map -- wskaźnik na mapę
+ * @param addedRoad -- odcinek drogowy
+ * @return false, jeśli nie udało się zaalokować pamięci; w przeciwnym wypadku true
+ */
+bool attachRoad(Map *map, Road *addedRoad);
 
 /**
  * @brief Wyszukuje odcinek drogi między dwoma podanymi miastami.
@@ -31,11 +94,14 @@ void addToRoadList(City *whereRoad, RoadList *addedRoad);
 Road *findRoadBetweenCities(Map *map, const char *city1, const char *city2);
 
 /**
- * @brief Usuwa odcinek drogowy z listy odcinków danego miasta.
+ * @brief Usuwa odcinek drogowy z tablic odcinków obu jego końców i z indeksu
+ * odcinków mapy.
+ * Na jego miejsce przenosi ostatni odcinek danej tablicy. Poprawia migawkę
+ * sąsiedztwa i zwiększa licznik zmian sieci dróg.
+ * @param map -- wskaźnik na mapę
  * @param pRoad -- wskaznik na usuwany odcinek drogi
- * @param pCity -- wskaznik na miasto z którego listy usuwamy odcinek drogi
  */
-void removeFromRoadList(Road *pRoad, City *pCity);
+void detachRoad(Map *map, Road *pRoad);
 
 /** @brief Sprawdza czy istnieje miasto o danej nazwie.
  * Funkcja szuka na liście miast będacej częścią mapy
@@ -47,6 +113,17 @@ void removeFromRoadList(Road *pRoad, City *pCity);
  */
 City* findCity(Map *map, const char *cityName);
 
+/** @brief Sprawdza czy istnieje miasto o danej nazwie, której hash jest znany.
+ * Pozwala policzyć hash nazwy raz na polecenie, nawet jeśli nazwa jest
+ * wyszukiwana kilka razy lub miasto jest potem tworzone.
+ * @param[in] map        – wskaźnik na strukturę przechowującą mapę dróg;
+ * @param[in] cityName   – wskaźnik na napis reprezentujący nazwę miasta;
+ * @param[in] hash       – wynik hashKey(cityName);
+ * @return Wskaźnik na miasto, jesli takie miasto istnieje
+ * lub NULL, jeśli nie ma takiego miasta.
+ */
+City* findCityHashed(Map *map, const char *cityName, uint64_t hash);
+
 /** @brief Sprawdza czy nazwa jest poprawną nazwą dla miasta.
  * Funkcja szuka w ciągu znaków znaków o kodach od 0 do 31, średników, oraz
  * sprawdza czy ciąg nie jest pusty.
@@ -58,26 +135,30 @@ bool isCorrectName(const char *name);
 
 /**
  * @brief Tworzy nowy odcinek drogowy między podanymi miastami i dodaje go do list odcinków obydwu miast.
+ * @param map -- wskaźnik na mapę
  * @param cityA Pierwsze miasto.
  * @param cityB Drugie miasto.
  * @param length Długość odcinka.
  * @param builtYear Rok wybudowania.
  * @return false, jeśli nie udało się zaalokować pamięci; w przeciwnym wypadku true
  */
-bool makeNewRoad(City *cityA, City *cityB, unsigned length,
+bool makeNewRoad(Map *map, City *cityA, City *cityB, unsigned length,
                  int builtYear);
 
 /**
  * @brief Tworzy miasto o zadanej nazwie i dodaje je do mapy.
  * @param map -- wskaźnik na mapę
  * @param name -- łańcuch znaków zawierający nazwę miasta
+ * @param hash -- wynik hashKey(name)
  * @return Wskaźnik do utworzonej struktury miasta.
  */
-City *makeNewCity(Map *map, const char *name);
+City *makeNewCity(Map *map, const char *name, uint64_t hash);
 
 /**
  * @brief Implementacja algorytmu djkstry
- * Znajduje najkrótszą drogę z miasta 'start' do miasta 'finish'
+ * Znajduje najkrótszą drogę z miasta 'start' do miasta 'finish'. Kolejne
+ * miasta są wyjmowane z kopca binarnego, więc wyszukiwanie działa w czasie
+ * O((V+E) log V).
  * @param map -- wskaźnik na mapę
  * @param routeId -- numer drogi krajowej
  * @param start -- miasto początkowe
@@ -87,7 +168,109 @@ City *makeNewCity(Map *map, const char *name);
 Route *dkstra(Map *map, unsigned int routeId, City *start, City *finish);
 
 /**
- * @brief Wstawia jedną drogę krajową w drugą. Zakładamy że mamy miejsce.
+ * @brief Przygotowuje struktury pomocnicze algorytmu wybranego w mapie
+ * Wołana przed wyszukiwaniem w funkcjach newRoute i extendRoute, a nie przy
+ * wyznaczaniu objazdów, gdy usuwany odcinek jest tylko odłączony. Jeśli
+ * przygotowanie się nie powiedzie, findRoute użyje zwykłego wyszukiwania.
+ * @param map -- wskaźnik na mapę
+ * @param routeId -- numer drogi krajowej, dla której wyszukiwana jest droga
+ */
+void prepareSearch(Map *map, unsigned routeId);
+
+/**
+ * @brief Wyznacza drogę krajową z miasta 'start' do miasta 'finish'
+ * Wybiera algorytm wyszukiwania zgodnie z trybem ustawionym w mapie.
+ * Zwracana droga jest taka sama niezależnie od wybranego algorytmu.
+ * @param map -- wskaźnik na mapę
+ * @param routeId -- numer drogi krajowej, której miasta są omijane
+ * @param start -- miasto początkowe
+ * @param finish -- miasto końcowe
+ * @return Potencjalna droga krajowa, albo NULL jeśli nie ma jednoznacznej
+ * drogi z A do B
+ */
+Route *findRoute(Map *map, unsigned routeId, City *start, City *finish);
+
+/**
+ * @brief Oznacza miasta drogi krajowej jako odwiedzone w obu kierunkach
+ * wyszukiwania, aby nowy fragment drogi jej nie przecinał. Jeśli droga ma
+ * indeks pozycji miast, miasta są oznaczane dopiero przy pierwszym dotknięciu
+ * przez wyszukiwanie, więc koszt nie zależy od długości drogi.
+ * @param map -- wskaźnik na mapę
+ * @param routeId -- numer drogi krajowej
+ */
+void blockRouteCities(Map *map, unsigned routeId);
+
+/**
+ * @brief Relaksacja odcinka drogi w algorytmie djkstry
+ * Poprawia odległość, najgorszy wiek i poprzednika miasta 'neighbour', jeśli
+ * droga przez miasto 'actCity' jest krótsza, lub tak samo długa, ale
+ * z młodszym najstarszym odcinkiem. Jeśli obie drogi są równie dobre, to
+ * poprzednik przestaje być jednoznaczny. Drogi o długości co najmniej INFINITY
+ * są pomijane, tak jak w funkcji addLength.
+ * @param map -- wskaźnik na mapę
+ * @param actCity -- miasto, z którego prowadzi odcinek
+ * @param neighbour -- nieodwiedzone miasto, do którego prowadzi odcinek
+ * @param length -- długość relaksowanego odcinka
+ * @param year -- rok budowy lub ostatniego remontu relaksowanego odcinka
+ * @return false, jeśli nie udało się zaalokować pamięci; w przeciwnym wypadku true
+ */
+bool relaxRoad(Map *map, City *actCity, City *neighbour, unsigned length,
+               int year);
+
+/**
+ * @brief Dopisuje miasto na koniec pomocniczej listy miast mapy
+ * @param map -- wskaźnik na mapę
+ * @param city -- dopisywane miasto
+ * @return false, jeśli nie udało się zaalokować pamięci; w przeciwnym wypadku true
+ */
+bool appendToSearchList(Map *map, City *city);
+
+/**
+ * @brief Ustala najgorszy wiek i poprzedników miast leżących na najkrótszych
+ * drogach z miasta 'start' do miasta 'finish'.
+ * Wymaga, aby wszystkie takie miasta były odwiedzone w bieżącym wyszukiwaniu
+ * i miały dokładną odległość od początku, ale nie zależy od kolejności, w
+ * jakiej wyszukiwanie je odwiedziło. Wynik jest taki, jaki dałby algorytm
+ * djkstry, więc można go przekazać do routeFromPrevious. Migawka sąsiedztwa
+ * mapy musi być aktualna.
+ * @param map -- wskaźnik na mapę
+ * @param start -- miasto początkowe
+ * @param finish -- miasto końcowe, osiągnięte przez wyszukiwanie
+ * @return false, jeśli nie udało się zaalokować pamięci; w przeciwnym wypadku true
+ */
+bool labelShortestPaths(Map *map, City *start, City *finish);
+
+/**
+ * @brief Tworzy drogę krajową, idąc po poprzednikach od miasta 'finish'
+ * @param map -- wskaźnik na mapę
+ * @param start -- miasto początkowe
+ * @param finish -- miasto końcowe
+ * @return Droga krajowa, albo NULL jeśli któryś poprzednik na drodze nie jest
+ * jednoznaczny lub nie udało się zaalokować pamięci
+ */
+Route *routeFromPrevious(Map *map, City *start, City *finish);
+
+/**
+ * @brief Usuwa drogę krajową wraz z jej tablicami. Nie wykreśla jej z list
+ * odcinków ani z rejestru mapy.
+ * @param route -- droga krajowa, może być NULL
+ */
+void freeRoute(Route *route);
+
+/**
+ * @brief Zapewnia, że tablice miast i odcinków drogi krajowej pomieszczą
+ * podaną liczbę miast. Pojemność rośnie geometrycznie, więc dopisywanie miast po jednym
+ * kosztuje łącznie czas liniowy.
+ * @param route -- droga krajowa
+ * @param needed -- wymagana liczba miast
+ * @return false, jeśli nie udało się zaalokować pamięci (droga pozostaje
+ * niezmieniona); w przeciwnym wypadku true
+ */
+bool reserveRouteCities(Route *route, unsigned needed);
+
+/**
+ * @brief Wstawia jedną drogę krajową w drugą. Zakładamy że mamy miejsce,
+ * zarezerwowane wcześniej przez reserveRouteCities().
  * @param target -- wskaźnik na drogę do której dodajemy drugą
  * @param source -- wskaźnik na dodawaną drogę
  * @param from -- wstawiamy od miasta o tym indeksie włącznie
@@ -96,54 +279,90 @@ Route *dkstra(Map *map, unsigned int routeId, City *start, City *finish);
 void insertIntoRoute(Route *target, Route *source, unsigned from, unsigned to);
 
 /**
- * @brief Sprawdza poprawność potencjalnej drogi krajowej
- * Funkcja sprawdza czy droga krajowa która powstanie po usunięciu odcinka drogi
- * będzie poprawną funkcją
+ * @brief Naprawia drogi krajowe przechodzące przez usuwany odcinek
+ * Każda droga krajowa z listy odcinka dostaje w jego miejsce najkrótszy objazd.
+ * Pozostałych dróg krajowych funkcja nie dotyka, więc działa w czasie zależnym
+ * tylko od dróg przechodzących przez odcinek. Odcinek musi być już odłączony
+ * od miast.
  * @param map -- wskaźnik na mapę dróg krajowych
- * @param cityA -- miasto początkowe
- * @param cityB -- miasto końcowe
- * @return Wartość @p true jeśli jest poprawna, wartość @p false w przeciwnym wypadku
+ * @param road -- usuwany odcinek
+ * @return Wartość @p true jeśli wszystkie drogi naprawiono, wartość @p false
+ * jeśli któraś nie ma objazdu, przechodzi przez odcinek więcej niż raz, lub
+ * zabrakło pamięci; wtedy drogi krajowe pozostają niezmienione
  */
-bool checkRoutesAfterRoadRemoval(Map *map, City *cityA, City *cityB);
+bool checkRoutesAfterRoadRemoval(Map *map, Road *road);
 
 /**
- * @brief Sprawdza czy na mapie są jeszcze nieodwiedzone węzły
- * @param map -- wskaźnik na mapę dróg krajowych
- * @return Wartość @p true jeśli tak, wartość @p false w przeciwnym wypadku
+ * @brief Zapisuje drogę krajową na listach odcinków, przez które przechodzi
+ * dany fragment jej trasy
+ * @param route -- droga krajowa
+ * @param roads -- kolejne odcinki fragmentu
+ * @param count -- liczba odcinków fragmentu
+ * @return false, jeśli nie udało się zaalokować pamięci; wtedy żadna lista nie
+ * jest zmieniona; w przeciwnym wypadku true
  */
-bool thereAreUnvisitedNodes(Map *map);
+bool linkRouteSegments(Route *route, Road **roads, unsigned count);
 
 /**
- * @brief Funkcja używana przez algorytm djkstry
- * Funkcja znajduje węzeł o najmniejszej odległosci od startu
- * @param map -- wskaźnik na mapę dróg krajowych
- * @return Wskaźnik na najbliższy węzeł, null jeśli nie zostały nieodwiedzone węzłyu
+ * @brief Wykreśla drogę krajową z list odcinków, przez które przechodzi dany
+ * fragment jej trasy
+ * @param route -- droga krajowa
+ * @param roads -- kolejne odcinki fragmentu
+ * @param count -- liczba odcinków fragmentu
  */
-City *lowestDistanceNode(Map *map);
+void unlinkRouteSegments(Route *route, Road **roads, unsigned count);
 
 /**
  * @brief Funkcja znajdująca odcinek drogi pomiędzy danymi miastami
+ * Korzysta z indeksu odcinków, więc działa w czasie stałym niezależnie od
+ * liczby odcinków wychodzących z miast.
+ * @param map -- wskaźnik na mapę
  * @param start -- wskaźnik na pierwsze miasto
  * @param finish -- wskaźnik na drugie miasto
  * @return Wskaźnik na drogę, NULL jeśli nie ma
  */
-Road *findRoadBetween(City *start, City *finish);
+Road *findRoadBetween(Map *map, City *start, City *finish);
 
 /**
- * @brief Funkcja sprawdza czy droga krajowa jest pusta
- * @param route -- wskaźnik na drogę krajową
- * @param cityA -- wskaźnik na pierwsze miasto
- * @param cityB -- wskaźnik na drugie miasto
- * @return Wartość @p true jeśli nie jest, wartość @p false jeśli nie
- */
-bool hasCities(Route *route, City *cityA, City *cityB);
-
-/**
- * @brief Znajduje kolejność miasta na drodze krajowej
+ * @brief Znajduje kolejność miasta na drodze krajowej. Przy pierwszym wywołaniu
+ * tworzy indeks pozycji miast drogi, więc kolejne wyszukiwania działają
+ * w czasie stałym.
  * @param route -- wskaźnik na drogę krajową
  * @param cityA -- wskaźnik na miasto
  * @return Kolejność miasta na drodze, albo nieskończoność jeśli nie ma takiego miasta
  */
 unsigned findCityIndex(Route *route, City *cityToFind);
 
+/**
+ * @brief Dopisuje do indeksu pozycji miast drogi jej miasta od danej pozycji
+ * do końca. Jeśli drogi nie ma jeszcze indeksu, nic nie robi; jeśli zabraknie
+ * pamięci, usuwa indeks, który zostanie odbudowany przy kolejnym wyszukiwaniu.
+ * @param route -- droga krajowa
+ * @param from -- pozycja pierwszego dopisywanego miasta
+ */
+void indexRouteTail(Route *route, unsigned from);
+
+/**
+ * @brief Tworzy opis drogi krajowej w formacie getRouteDescription().
+ * Rozmiar opisu jest liczony przed zapisem, więc opis zajmuje jedną alokację.
+ * @param route -- droga krajowa
+ * @param length -- tu zapisywana jest długość opisu, bez kończącego zera
+ * @return Zaalokowany napis, albo NULL jeśli nie udało się zaalokować pamięci
+ */
+char *describeRoute(Route *route, size_t *length);
+
+/**
+ * @brief Zwraca zapamiętany opis drogi krajowej, tworząc go w razie potrzeby
+ * @param route -- droga krajowa
+ * @return Opis należący do drogi, albo NULL jeśli nie udało się zaalokować
+ * pamięci
+ */
+const char *cachedDescription(Route *route);
+
+/**
+ * @brief Unieważnia zapamiętany opis drogi krajowej
+ * @param route -- droga krajowa
+ */
+void forgetDescription(Route *route);
+
 #endif //DROGI_MAP_OPERATIONS_H
@@ -7,66 +7,74 @@
 
 #include "map_userInterface.h"
 #include "map.h"
-#include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
 #include <string.h>
-#include <errno.h>
-
-#define CHAR_BUFFER 4096
+#include <ctype.h>
+#include <unistd.h>
+#include <sys/stat.h>
 
 /**
- * @brief Zamienia podany string na odpowiadającą mu wartość int. Funkcja pomocnicza
- * Funkcja zamienia string naint za pomocą funkcji strtol. Funkcja szuka na końcu
- * znaku '\0' aby upewnic sie ze dostala poprawna wartosc numeryczna.
- * Odczytana wartość jest przypisana parametrowi "numerical"
- * @param string [in,out]
- * @param isLastArgument [in]
- * @param numerical [out]
- * @return wartość @p true, jeśli się udało, wartość @p false jeśli wystąpił błąd:
- * wartość za duża, za mała, lub nieoczekiwane znaki.
+ * @brief Bufory standardowego wyjścia i wyjścia diagnostycznego. Jeśli oba
+ * wyjścia trafiają do tego samego pliku, oba wskaźniki wskazują ten sam bufor.
  */
-static bool parseStringToInt(char* string, int *numerical)
+struct Outputs
 {
-    errno = 0;
-    char *lengthIntLastChar;
-    long castCheck = strtol(string, &lengthIntLastChar, 10);
-
-    if (castCheck > INT_MAX || castCheck < INT_MIN) return false;
+    /**
+     * @brief Bufor standardowego wyjścia
+     */
+    OutputWriter *output;
+
+    /**
+     * @brief Bufor standardowego wyjścia diagnostycznego
+     */
+    OutputWriter *errors;
+};
+typedef struct Outputs Outputs;
 
-    if (*lengthIntLastChar != '\0') return false;
+/**
+ * @brief Sprawdza, czy dwa deskryptory wskazują ten sam plik. Funkcja pomocnicza
+ * @param first[in]             - Pierwszy deskryptor
+ * @param second[in]            - Drugi deskryptor
+ * @return wartość @p true, jeśli to ten sam plik, @p false w przeciwnym
+ * wypadku lub jeśli nie udało się tego sprawdzić
+ */
+static bool sameFile(int first, int second)
+{
+    struct stat firstStat, secondStat;
 
-    if (errno == ERANGE || errno == EINVAL) return false;
+    if (fstat(first, &firstStat) != 0 || fstat(second, &secondStat) != 0)
+    {
+        return false;
+    }
 
-    *numerical = castCheck;
-    return true;
+    return firstStat.st_dev == secondStat.st_dev &&
+           firstStat.st_ino == secondStat.st_ino;
 }
 
 /**
- * @brief Zamienia podany string na odpowiadającą mu wartość unsigned. Funkcja pomocnicza
- * Funkcja zamienia string na unsigned int za pomocą funkcji strtol. Funkcja
- * szuka na końcu znaku '\0' aby upewnic sie ze dostala poprawna wartosc numeryczna.
- * Odczytana wartość jest przypisana parametrowi "numerical"
- * @param string [in,out]
- * @param isLastArgument [in]
- * @param numerical [out]
- * @return wartość @p true, jeśli się udało, wartość @p false jeśli wystąpił błąd:
- * wartość za duża, za mała, lub nieoczekiwane znaki.
+ * @brief Wypisuje zawartość obu buforów. Funkcja pomocnicza
+ * Funkcja wywoływana przez czytnik przed czekaniem na kolejne dane.
+ * @param data[in,out]          - Wskaźnik na bufory (Outputs)
  */
-static bool parseStringToUnsigned(char *string, unsigned *numerical)
+static void flushOutputs(void *data)
 {
-    errno = 0;
-    char *lengthIntLastChar;
-    long castCheck = strtol(string, &lengthIntLastChar, 10);
-
-    if (castCheck > UINT_MAX || castCheck < 0) return false;
+    Outputs *outputs = data;
 
-    if (*lengthIntLastChar != '\0') return false;
+    flushOutput(outputs->output);
+    if (outputs->errors != outputs->output) flushOutput(outputs->errors);
+}
 
-    if (errno == ERANGE || errno == EINVAL) return false;
+/**
+ * @brief Wypisuje i usuwa oba bufory. Funkcja pomocnicza
+ * @param outputs[in,out]       - Wskaźnik na bufory; brakujące są pomijane
+ */
+static void removeOutputs(Outputs *outputs)
+{
+    bool shared = outputs->errors == outputs->output;
 
-    *numerical = castCheck;
-    return true;
+    removeOutputWriter(outputs->output);
+    if (!shared) removeOutputWriter(outputs->errors);
 }
 
 /**
@@ -74,117 +82,166 @@ static bool parseStringToUnsigned(char *string, unsigned *numerical)
  * Wypisuje komunikat o błędzie na standardowe wyjście diagnostyczne, w formacie
  * "ERROR x", gdzie x to numer linii w której wpisano błędne polecenie.
  * Funkcja pomocnicza używana przez userReadInput
+ * @param errors[in,out]        -Bufor standardowego wyjścia diagnostycznego
  * @param lineNumber[in]        -Numer linii, w której wpisano błędne polecenie
  * */
-static void printErrorMessage(int lineNumber)
+static void printErrorMessage(OutputWriter *errors, int lineNumber)
 {
-    fprintf(stderr, "ERROR %d\n", lineNumber);
+    writeOutput(errors, "ERROR ", 6);
+    writeNumber(errors, lineNumber);
+    writeCharacter(errors, '\n');
 }
 
 /**
- * @brief Resetuje string. Funkcja pomocnicza
- * Ustawia pierwszy znak w zadanym stringu na NULL, aby uniknąć błędów przy
- * późniejszym odczycie i zapisie.
- * Funkcja pomocnicza używana przez userReadInput
- * @param string[in,out]        -Resetowany string
- * */
-static inline void resetString(char *string)
+ * @brief Rodzaj polecenia, rozpoznany po pierwszym wyrazie wiersza
+ */
+enum Command
 {
-    string[0] = '\0';
-}
+    /**
+     * @brief Polecenie addRoad
+     */
+    COMMAND_ADD_ROAD,
+
+    /**
+     * @brief Polecenie repairRoad
+     */
+    COMMAND_REPAIR_ROAD,
+
+    /**
+     * @brief Polecenie getRouteDescription
+     */
+    COMMAND_GET_ROUTE_DESCRIPTION,
+
+    /**
+     * @brief Polecenie removeRoad
+     */
+    COMMAND_REMOVE_ROAD,
+
+    /**
+     * @brief Polecenie removeRoute
+     */
+    COMMAND_REMOVE_ROUTE,
+
+    /**
+     * @brief Polecenie newRoute
+     */
+    COMMAND_NEW_AUTO_ROUTE,
+
+    /**
+     * @brief Polecenie extendRoute
+     */
+    COMMAND_EXTEND_ROUTE,
+
+    /**
+     * @brief Numer drogi krajowej i jej przebieg
+     */
+    COMMAND_MAKE_ROUTE
+};
 
 /**
- * @brief Sprawdza czy udało się wczytać całą linię tekstu. Funkcja pomocnicza
- * Funkcja szuka w zadanym stringu znaku końca linii. Jego brak oznacza że
- * nie wszystkie znaki w linii zostały poprawnie wczytane.
- * Funkcja pomocnicza używana przez userReadInput
- * @param string[in]            -Sprawdzany string
- * @return wartość @p true, jeśli znaleziono znak konca linii, wartość @p false
- * w przeciwnym wypadku.
+ * @brief Nazwy poleceń, w kolejności wartości enum Command
+ */
+static const char *const commandNames[] =
+{
+    ADD_ROAD,
+    REPAIR_ROAD,
+    GET_ROUTE_DESCRIPTION,
+    REMOVE_ROAD,
+    REMOVE_ROUTE,
+    NEW_AUTO_ROUTE,
+    EXTEND_ROUTE
+};
+
+/**
+ * @brief Rozpoznaje polecenie po jego pierwszym wyrazie. Funkcja pomocnicza
+ * Długość wyrazu i co najwyżej jeden jego znak wskazują jedyną nazwę, z którą
+ * wyraz może być równy, więc wystarczy jedno porównanie. Wyraz, który nie jest
+ * nazwą polecenia, jest numerem drogi krajowej tworzonej przez userMakeRoute.
+ * Funkcja pomocnicza używana przez analyzeString
+ * @param command[in]           - Pierwszy wyraz wiersza
+ * @return Rodzaj polecenia
  * */
-static inline bool entireLineRead(char *string)
+static enum Command classifyCommand(const Token *command)
 {
-    char *success = strchr(string, '\n');
-    if (success == NULL)
+    const char *text = command->text;
+
+    // a route number never names a command, so custom routes go straight on
+    if (isdigit((unsigned char) text[0])) return COMMAND_MAKE_ROUTE;
+
+    enum Command candidate;
+    switch (command->length)
     {
-        return false;
+        case 7:
+            candidate = COMMAND_ADD_ROAD;
+            break;
+        case 8:
+            candidate = COMMAND_NEW_AUTO_ROUTE;
+            break;
+        case 10: // repairRoad, removeRoad
+            candidate = text[2] == 'p' ? COMMAND_REPAIR_ROAD
+                                       : COMMAND_REMOVE_ROAD;
+            break;
+        case 11: // removeRoute, extendRoute
+            candidate = text[0] == 'r' ? COMMAND_REMOVE_ROUTE
+                                       : COMMAND_EXTEND_ROUTE;
+            break;
+        case 19:
+            candidate = COMMAND_GET_ROUTE_DESCRIPTION;
+            break;
+        default:
+            return COMMAND_MAKE_ROUTE;
     }
-    else
+
+    if (memcmp(text, commandNames[candidate], command->length) != 0)
     {
-        return true;
+        return COMMAND_MAKE_ROUTE;
     }
+
+    return candidate;
 }
 
 /**
- * @brief Analizuje string i wywołuje odpowiednią funkcję. Funkcja pomocnicza
- * Funkcja sprawdza czy skłądnia stringa odpowiada któremuś z poprawnych poleceń.
+ * @brief Analizuje wiersz i wywołuje odpowiednią funkcję. Funkcja pomocnicza
+ * Funkcja sprawdza czy skłądnia wiersza odpowiada któremuś z poprawnych poleceń.
  * Jeżeli tak, to wywoluje je, jeżeli nie to zwraca wartość false będącą
- * informacją o błędzie. String zostanie pofragmentowany.
+ * informacją o błędzie. Wiersz zostanie pofragmentowany.
  * Funkcja pomocnicza używana przez userReadInput
  * @param map[in]                    - Wskaźnik na strukturę zawierającą mapę dróg krajowych
- * @param command[in,out]            - Sprawdzany string
- * @return wartość @p true, jeśli string jest poprawnym poleceniem, ktore zostało
+ * @param input[in,out]              - Czytnik z wczytanym wierszem
+ * @param output[in,out]             - Bufor standardowego wyjścia
+ * @return wartość @p true, jeśli wiersz jest poprawnym poleceniem, ktore zostało
  * poprawnie wykonane. Wartość @p false w przeciwnym wypadku.
  * */
-static bool analyzeString(Map *map, char *command)
+static bool analyzeString(Map *map, InputReader *input, OutputWriter *output)
 {
-    // line without '\n'
-    if (!entireLineRead(command))
-    {
-        return false;
-    }
-
     // lines starting with '#' and empty lines are ignored
-    if (command[0] == '#' || command[0] == '\n')
+    if (input->line[0] == '#' || input->line[0] == '\n')
     {
         return true;
     }
 
-    ADD_ROAD
-    REPAIR_ROAD
-    GET_ROUTE_DESCRIPTION
-    REMOVE_ROAD
-    REMOVE_ROUTE
-    NEW_AUTO_ROUTE
-    EXTEND_ROUTE
-    DELIMITER
-
-    char *whichCommand = strtok(command, delimiter);
-
-    if (strcmp(whichCommand, addRoad) == 0) // addRoad
-    {
-        if (!userAddRoad(map)) return false;
-    }
-    else if (strcmp(whichCommand, repairRoad) == 0) // repairRoad
-    {
-        if (!userRepairRoad(map)) return false;
-    }
-    else if (strcmp(whichCommand, getRouteDescription) == 0) // getRtDescription
-    {
-        if (!userGetRouteDescription(map)) return false;
-    }
-    else if (strcmp(whichCommand, removeRoad) == 0) // removeRoad
-    {
-        if (!userRemoveRoad(map)) return false;
-    }
-    else if (strcmp(whichCommand, removeRoute) == 0) // removeRoute
-    {
-        if (!userRemoveRoute(map)) return false;
+    Token command;
+    if (!nextToken(input, &command)) return false;
+
+    switch (classifyCommand(&command))
+    {
+        case COMMAND_ADD_ROAD:
+            return userAddRoad(map, input);
+        case COMMAND_REPAIR_ROAD:
+            return userRepairRoad(map, input);
+        case COMMAND_GET_ROUTE_DESCRIPTION:
+            return userGetRouteDescription(map, input, output);
+        case COMMAND_REMOVE_ROAD:
+            return userRemoveRoad(map, input);
+        case COMMAND_REMOVE_ROUTE:
+            return userRemoveRoute(map, input);
+        case COMMAND_NEW_AUTO_ROUTE:
+            return userNewAutoRoute(map, input);
+        case COMMAND_EXTEND_ROUTE:
+            return userExtendRoute(map, input);
+        default:
+            return userMakeRoute(map, input, &command);
     }
-    else if (strcmp(whichCommand, newAutoRoute) == 0) // userNewAutoRoute
-    {
-        if (!userNewAutoRoute(map)) return false;
-    }
-    else if (strcmp(whichCommand, extendRoute) == 0) // userExtendRoute
-    {
-        if (!userExtendRoute(map)) return false;
-    }
-    else // makeRoute
-    {
-        if (!userMakeRoute(map, whichCommand)) return false;
-    }
-
-    return true;
 }
 
 /**
@@ -195,125 +252,118 @@ static bool analyzeString(Map *map, char *command)
  * albo ostatni wyraz nie kończy się poprawnym znakiem. Znak konca linii zostaje
  * potem usuniety, poniewaz nie bedzie juz potrzebny
  * Funkcja pomocnicza używana przez wiele funkcji
- * @param argument[in]            - Sprawdzany string, ostatni wyraz polecenia
+ * @param argument[in]            - Sprawdzany wyraz, ostatni wyraz polecenia
  * @return wartość @p true, jeśli otrzymaliśmy za dużo argumentów.
  * Wartość @p false w przeciwnym wypadku.
  * */
-static bool tooManyArguments(char *argument)
+static bool tooManyArguments(Token *argument)
 {
-    unsigned length = strlen(argument);
-
-    if (*(argument + (length - 1)) != '\n')
+    if (argument->text[argument->length - 1] != '\n')
     {
         return true;
     }
 
     else
     {
-        *(argument + (length - 1)) = '\0';
+        argument->text[--argument->length] = '\0';
         return false;
     }
 }
 
-bool userAddRoad(Map *map)
+bool userAddRoad(Map *map, InputReader *input)
 {
-    DELIMITER
+    Token city1, city2, length, year;
 
-    char *city1 = strtok(NULL, delimiter);
-    char *city2 = strtok(NULL, delimiter);
-    char *length = strtok(NULL, delimiter);
-    char *year = strtok(NULL, delimiter);
-
-    if (city1 == NULL || city2 == NULL || length == NULL || year == NULL)
+    if (!nextToken(input, &city1) || !nextToken(input, &city2) ||
+        !nextToken(input, &length) || !nextToken(input, &year))
     {
         // not enough arguments
         return false;
     }
-    if (tooManyArguments(year))
+    if (tooManyArguments(&year))
     {
         return false;
     }
 
     unsigned lengthInt;
-    if (!parseStringToUnsigned(length, &lengthInt)) return false;
+    if (!tokenToUnsigned(&length, &lengthInt)) return false;
 
     int yearInt;
-    if (!parseStringToInt(year, &yearInt)) return false;
+    if (!tokenToInt(&year, &yearInt)) return false;
 
-    if (!addRoad(map, city1, city2, lengthInt, yearInt)) return false;
+    if (!addRoad(map, city1.text, city2.text, lengthInt, yearInt)) return false;
 
     return true;
 }
 
-bool userGetRouteDescription(Map *map)
+bool userGetRouteDescription(Map *map, InputReader *input,
+                             OutputWriter *output)
 {
-    DELIMITER
-
-    char *routeId = strtok(NULL, delimiter);
+    Token routeId;
 
-    if (routeId == NULL)
+    if (!nextToken(input, &routeId))
     {
         // not enough arguments
         return false;
     }
-    if (tooManyArguments(routeId))
+    if (tooManyArguments(&routeId))
     {
         return false;
     }
 
-    int routeIdInt;
-    if (!parseStringToInt(routeId, &routeIdInt)) return false;
+    unsigned routeIdInt;
+    if (!tokenToUnsigned(&routeId, &routeIdInt))
+    {
+        // a negative number is a valid argument naming no route, so it gets
+        // an empty description rather than an error
+        int negativeId;
+        if (!tokenToInt(&routeId, &negativeId)) return false;
+        routeIdInt = 0;
+    }
 
-    const char *string = getRouteDescription(map, routeIdInt);
+    // the map keeps the description, so it is printed without a copy
+    size_t length;
+    const char *string = peekRouteDescription(map, routeIdInt, &length);
     if (string == NULL) return false;
 
-    printf("%s\n", string);
-    free((void *)string);
+    writeOutput(output, string, length);
+    writeCharacter(output, '\n');
 
     return true;
 }
 
-bool userRepairRoad(Map *map)
+bool userRepairRoad(Map *map, InputReader *input)
 {
-    DELIMITER
-
-    char *city1 = strtok(NULL, delimiter);
-    char *city2 = strtok(NULL, delimiter);
-    char *year = strtok(NULL, delimiter);
+    Token city1, city2, year;
 
-    if (city1 == NULL || city2 == NULL || year == NULL)
+    if (!nextToken(input, &city1) || !nextToken(input, &city2) ||
+        !nextToken(input, &year))
     {
         // not enough arguments
         return false;
     }
-    if (tooManyArguments(year))
+    if (tooManyArguments(&year))
     {
         return false;
     }
 
     int yearInt;
-    if (!parseStringToInt(year, &yearInt)) return false;
+    if (!tokenToInt(&year, &yearInt)) return false;
 
-    if (!repairRoad(map, city1, city2, yearInt)) return false;
+    if (!repairRoad(map, city1.text, city2.text, yearInt)) return false;
 
     return true;
 }
 
-bool userMakeRoute(Map *map, char *command)
+bool userMakeRoute(Map *map, InputReader *input, Token *routeId)
 {
-    DELIMITER
+    unsigned routeIdInt;
+    if (!tokenToUnsigned(routeId, &routeIdInt)) return false;
 
-    char *routeId = command;
+    Token startCity;
+    if (!nextToken(input, &startCity)) return false;
 
-    if (routeId == NULL) return false;
-
-    int routeIdInt;
-    if (!parseStringToInt(routeId, &routeIdInt)) return false;
-
-    char *startCity = strtok(NULL, delimiter);
-    if (startCity == NULL) return false;
-
-    Route *newRoute = newCustomRoute(map, routeIdInt, startCity);
+    Route *newRoute = newCustomRoute(map, routeIdInt, startCity.text);
     if (newRoute == NULL)
     {
         return false;
@@ -322,30 +372,30 @@ bool userMakeRoute(Map *map, char *command)
     bool allRead = false;
     while (!allRead)
     {
-        char *length = strtok(NULL, delimiter);
-        char *year = strtok(NULL, delimiter);
-        char *destination = strtok(NULL, delimiter);
+        Token length, year, destination;
 
-        if (length == NULL || year == NULL || destination == NULL)
+        if (!nextToken(input, &length) || !nextToken(input, &year) ||
+            !nextToken(input, &destination))
         {
             // means syntax error
             return false;
         }
 
-        if (destination[strlen(destination)-1] == '\n')
+        if (destination.text[destination.length - 1] == '\n')
         {
             // it was last argument
-            destination[strlen(destination)-1] = '\0';
+            destination.text[--destination.length] = '\0';
             allRead = true;
         }
 
         unsigned lengthInt;
-        if (!parseStringToUnsigned(length, &lengthInt)) return false;
+        if (!tokenToUnsigned(&length, &lengthInt)) return false;
 
         int yearInt;
-        if (!parseStringToInt(year, &yearInt)) return false;
+        if (!tokenToInt(&year, &yearInt)) return false;
 
-        if (!extendCustomRoute(map, routeIdInt, lengthInt, yearInt, destination))
+        if (!extendCustomRoute(map, routeIdInt, lengthInt, yearInt,
+                               destination.text))
         {
             return false;
         }
@@ -367,58 +417,39 @@ void userReadInput(Map *map)
 
     int lineNumber = 0;
 
-    char *buffer = malloc(sizeof(char) * CHAR_BUFFER);
-    int bufferSize = CHAR_BUFFER;
-    resetString(buffer);
+    InputReader *input = newInputReader(STDIN_FILENO);
+    Outputs outputs;
+    outputs.output = newOutputWriter(STDOUT_FILENO);
+    // one buffer for both keeps the order of lines written to the same file
+    outputs.errors = sameFile(STDOUT_FILENO, STDERR_FILENO)
+                     ? outputs.output : newOutputWriter(STDERR_FILENO);
 
-    char *command = malloc(sizeof(char) * CHAR_BUFFER);
-    int commandSize = CHAR_BUFFER;
-    int lastWriteToBufferPosition = 0;
-    resetString(command);
+    if (input == NULL || outputs.output == NULL || outputs.errors == NULL)
+    {
+        removeInputReader(input);
+        removeOutputs(&outputs);
+        if (madeOwnMap) deleteMap(map);
+        return;
+    }
 
-    while (fgets(buffer, bufferSize, stdin) != NULL)
+    // answers are written out before the reader waits for more commands
+    setBeforeRead(input, flushOutputs, &outputs);
+
+    LineStatus status;
+    while ((status = readLine(input)) != LINE_NONE)
     {
         ++lineNumber;
-        strcpy(command, buffer);
 
-        while (!entireLineRead(command))
+        // a line without '\n' ends the input, so nothing more is read
+        if (status == LINE_MALFORMED ||
+            !analyzeString(map, input, outputs.output))
         {
-            // command doesn`t fit, so we must increase size
-            commandSize += CHAR_BUFFER;
-            command = realloc(command, ((sizeof(char)) * commandSize));
-            // now we get next part of the line
-            resetString(buffer);
-            // if we entered this loop, then in worst case the only character
-            // not read is '\n'. If we get a null here, that means there is no
-            // '\n' in this line, so the file ends abruptly and that is an error
-            if (fgets(buffer, bufferSize, stdin) == NULL)
-            {
-                printErrorMessage(lineNumber);
-                free(buffer);
-                free(command);
-                if (madeOwnMap)
-                {
-                    deleteMap(map);
-                }
-                return;
-            }
-            // we want to overwrite NULL, so -1
-            lastWriteToBufferPosition += CHAR_BUFFER - 1;
-            strcpy(command + (lastWriteToBufferPosition), buffer);
+            printErrorMessage(outputs.errors, lineNumber);
         }
-
-        if (!analyzeString(map, command))
-        {
-            printErrorMessage(lineNumber);
-        }
-
-        resetString(command);
-        resetString(buffer);
-        lastWriteToBufferPosition = 0;
     }
 
-    free(buffer);
-    free(command);
+    removeInputReader(input);
+    removeOutputs(&outputs);
     // if we had to make our own map, we must delete it as we won`t pass it outside
     if (madeOwnMap)
     {
@@ -426,99 +457,88 @@ void userReadInput(Map *map)
     }
 }
 
-bool userRemoveRoad(Map *map)
+bool userRemoveRoad(Map *map, InputReader *input)
 {
-    DELIMITER
+    Token city1, city2;
 
-    char *city1 = strtok(NULL, delimiter);
-    char *city2 = strtok(NULL, delimiter);
-
-    if (city1 == NULL || city2 == NULL)
+    if (!nextToken(input, &city1) || !nextToken(input, &city2))
     {
         // not enough arguments
         return false;
     }
-    if (tooManyArguments(city2))
+    if (tooManyArguments(&city2))
     {
         return false;
     }
 
-    if (!removeRoad(map, city1, city2)) return false;
+    if (!removeRoad(map, city1.text, city2.text)) return false;
 
     return true;
 }
 
-bool userRemoveRoute(Map *map)
+bool userRemoveRoute(Map *map, InputReader *input)
 {
-    DELIMITER
-
-    char *routeId = strtok(NULL, delimiter);
+    Token routeId;
 
-    if (routeId == NULL)
+    if (!nextToken(input, &routeId))
     {
         // not enough arguments
         return false;
     }
-    if (tooManyArguments(routeId))
+    if (tooManyArguments(&routeId))
     {
         return false;
     }
 
-    int routeIdInt;
-    if (!parseStringToInt(routeId, &routeIdInt)) return false;
+    unsigned routeIdInt;
+    if (!tokenToUnsigned(&routeId, &routeIdInt)) return false;
 
     if (!removeRoute(map, routeIdInt)) return false;
 
     return true;
 }
 
-bool userNewAutoRoute(Map *map)
+bool userNewAutoRoute(Map *map, InputReader *input)
 {
-    DELIMITER
+    Token routeId, city1, city2;
 
-    char *routeId = strtok(NULL, delimiter);
-    char *city1 = strtok(NULL, delimiter);
-    char *city2 = strtok(NULL, delimiter);
-
-    if (routeId == NULL || city1 == NULL || city2 == NULL)
+    if (!nextToken(input, &routeId) || !nextToken(input, &city1) ||
+        !nextToken(input, &city2))
     {
         // not enough arguments
         return false;
     }
-    if (tooManyArguments(city2))
+    if (tooManyArguments(&city2))
     {
         return false;
     }
 
-    int routeIdInt;
-    if (!parseStringToInt(routeId, &routeIdInt)) return false;
+    unsigned routeIdInt;
+    if (!tokenToUnsigned(&routeId, &routeIdInt)) return false;
 
-    if (!newRoute(map, routeIdInt, city1, city2)) return false;
+    if (!newRoute(map, routeIdInt, city1.text, city2.text)) return false;
 
     return true;
 }
 
-bool userExtendRoute(Map *map)
+bool userExtendRoute(Map *map, InputReader *input)
 {
-    DELIMITER
-
-    char *routeId = strtok(NULL, delimiter);
-    char *city = strtok(NULL, delimiter);
+    Token routeId, city;
 
-    if (routeId == NULL || city == NULL)
+    if (!nextToken(input, &routeId) || !nextToken(input, &city))
     {
         // not enough arguments
         return false;
     }
-    if (tooManyArguments(city))
+    if (tooManyArguments(&city))
     {
         return false;
     }
 
-    int routeIdInt;
-    if (!parseStringToInt(routeId, &routeIdInt)) return false;
+    unsigned routeIdInt;
+    if (!tokenToUnsigned(&routeId, &routeIdInt)) return false;
 
-    if (!extendRoute(map, routeIdInt, city)) return false;
+    if (!extendRoute(map, routeIdInt, city.text)) return false;
 
     return true;
 }
\ No newline at end of file
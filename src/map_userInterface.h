@@ -10,25 +10,28 @@
 
 #include <stdbool.h>
 #include "map.h"
+#include "InputReader.h"
+#include "OutputWriter.h"
 
-#define ADD_ROAD const char *addRoad = "addRoad";
-#define REPAIR_ROAD const char *repairRoad = "repairRoad";
-#define GET_ROUTE_DESCRIPTION const char *getRouteDescription = "getRouteDescription";
-#define REMOVE_ROAD const char *removeRoad = "removeRoad";
-#define REMOVE_ROUTE const char *removeRoute = "removeRoute";
-#define NEW_AUTO_ROUTE const char *newAutoRoute = "newRoute";
-#define EXTEND_ROUTE const char *extendRoute = "extendRoute";
-#define DELIMITER const char *delimiter = ";";
+#define ADD_ROAD "addRoad"
+#define REPAIR_ROAD "repairRoad"
+#define GET_ROUTE_DESCRIPTION "getRouteDescription"
+#define REMOVE_ROAD "removeRoad"
+#define REMOVE_ROUTE "removeRoute"
+#define NEW_AUTO_ROUTE "newRoute"
+#define EXTEND_ROUTE "extendRoute"
 
 /**
  * @brief Przyjmuje polecenie od użytkownika
- * Funkcja przyjmuje polecenie ze standardowego wyjścia. Funkcja ignoruje
- * wiersze zaczynające się znakiem '#', oraz puste. Wypisuje informację o błędzie,
- * jeśli otrzymała niepoprawny parametr lub wywołanie funkcji zakońćzyło się błędem.
- * Komunikat jest wypisywany na standardowe wyjscie diagnostyczne, w formacie
- * "ERROR x", gdzie x to numer linii w której wpisano błędne polecenie. Jeżeli
- * funkcja nie dostanie gotowej mapy (dostanie NULL) to stworzy własną, pustą
- * mapę, którą na koniec działania usunie.
+ * Funkcja przyjmuje polecenie ze standardowego wejścia, czytając je dużymi
+ * porcjami, bez kopiowania wierszy. Odpowiedzi i komunikaty o błędach są
+ * zbierane w buforach i wypisywane przed każdym czekaniem na dalsze wejście.
+ * Funkcja ignoruje wiersze zaczynające się znakiem '#', oraz puste. Wypisuje
+ * informację o błędzie, jeśli otrzymała niepoprawny parametr lub wywołanie
+ * funkcji zakońćzyło się błędem. Komunikat jest wypisywany na standardowe
+ * wyjscie diagnostyczne, w formacie "ERROR x", gdzie x to numer linii w której
+ * wpisano błędne polecenie. Jeżeli funkcja nie dostanie gotowej mapy (dostanie
+ * NULL) to stworzy własną, pustą mapę, którą na koniec działania usunie.
  * @param map[in,out]       - Wskaźnik na strukturę zawierającą mapę dróg krajowych
  * */
 void userReadInput(Map *map);
@@ -36,90 +39,100 @@ void userReadInput(Map *map);
 /**
  * @brief Pozwala użytkownikowi stworzyć nową drogę krajową
  * Funkcja tworzy drogę krajową zgodnie z poleceniem zadanym przez użytkownika,
- * zawartym w podanym stringu. Funkcja dodaje po kolei kolejne miasta i drogi
+ * zawartym w wierszu czytnika. Funkcja dodaje po kolei kolejne miasta i drogi
  * do drogi krajowej, do momentu gdy natrafi na błąd lub koniec polecenia.
  * @param map[in]           - Wskaźnik na strukturę zawierającą mapę dróg krajowych
- * @param command[in]       - String zawierający polecenie
+ * @param input[in,out]     - Czytnik z wczytanym wierszem polecenia
+ * @param routeId[in]       - Pierwszy wyraz polecenia, numer drogi krajowej
  * @return wartość @p true jeśli wykonanie zakończyło się sukcesem, wartość @p
  * false w przeciwnym wypadku - niepoprawna składnia polecenia lub argumenty
  * */
-bool userMakeRoute(Map *map, char *command);
+bool userMakeRoute(Map *map, InputReader *input, Token *routeId);
 
 /**
  * @brief Pozwala użytkownikowi stworzyć nowy odcinek drogi
  * Funkcja tworzy odcinek drogi zgodnie z poleceniem zadanym przez użytkownika,
- * zawartym tokenach uzyskanych za pomocą strtok.
+ * zawartym tokenach uzyskanych za pomocą nextToken.
  * @param map[in]           - Wskaźnik na strukturę zawierającą mapę dróg krajowych
+ * @param input[in,out]     - Czytnik z wczytanym wierszem polecenia
  * @return wartość @p true jeśli wykonanie zakończyło się sukcesem, wartość @p
  * false w przeciwnym wypadku - niepoprawna składnia polecenia lub argumenty
  * */
-bool userAddRoad(Map *map);
+bool userAddRoad(Map *map, InputReader *input);
 
 /**
  * @brief Pozwala użytkownikowi wyremontować odcinek drogi
  * Funkcja remontuje odcinek drogi zgodnie z poleceniem zadanym przez użytkownika,
- * zawartym w tokenach uzyskanych za pomocą strtok
+ * zawartym w tokenach uzyskanych za pomocą nextToken
  * @param map[in]           - Wskaźnik na strukturę zawierającą mapę dróg krajowych
+ * @param input[in,out]     - Czytnik z wczytanym wierszem polecenia
  * @return wartość @p true jeśli wykonanie zakończyło się sukcesem, wartość @p
  * false w przeciwnym wypadku - niepoprawna składnia polecenia lub argumenty
  * */
-bool userRepairRoad(Map *map);
+bool userRepairRoad(Map *map, InputReader *input);
 
 /**
  * @brief Pozwala użytkownikowi uzyskać informację o danym odcinku drogi
  * Funkcja wypisuje informację o drodze krajowej zgodnie z poleceniem zadanym
- * przez użytkownika, zawartym w tokenach uzyskanych za pomocą strtok
+ * przez użytkownika, zawartym w tokenach uzyskanych za pomocą nextToken
  * @param map[in]           - Wskaźnik na strukturę zawierającą mapę dróg krajowych
+ * @param input[in,out]     - Czytnik z wczytanym wierszem polecenia
+ * @param output[in,out]    - Bufor, do którego trafia informacja
  * @return wartość @p true jeśli wykonanie zakończyło się sukcesem, wartość @p
  * false w przeciwnym wypadku  - niepoprawna składnia polecenia lub argumenty
  * */
-bool userGetRouteDescription(Map *map);
+bool userGetRouteDescription(Map *map, InputReader *input,
+                             OutputWriter *output);
 
 /**
  * @brief Pozwala użytkownikowi usunąć drogę pomiędzy dwoma miastami
  * Funkcja usuwa odcinek drogi pomiędzy dwoma miastami zgodnie z poleceniem zadanym
- * przez użytkownika, zawartym w tokenach uzyskanych za pomocą strtok
+ * przez użytkownika, zawartym w tokenach uzyskanych za pomocą nextToken
  * @param map[in]           - Wskaźnik na strukturę zawierającą mapę dróg krajowych
+ * @param input[in,out]     - Czytnik z wczytanym wierszem polecenia
  * @return wartość @p true jeśli wykonanie zakończyło się sukcesem, wartość @p
  * false w przeciwnym wypadku  - niepoprawna składnia polecenia lub argumenty
  * */
-bool userRemoveRoad(Map *map);
+bool userRemoveRoad(Map *map, InputReader *input);
 
 /**
  * @brief Pozwala użytkownikowi usunąć drogę krajową
  * Funkcja usuwa drogę krajową zgodnie z poleceniem zadanym
- * przez użytkownika, zawartym w tokenach uzyskanych za pomocą strtok.
+ * przez użytkownika, zawartym w tokenach uzyskanych za pomocą nextToken.
  * Odcinki drogi oraz miasta nie ulegają usunięciu.
  * @param map[in]           - Wskaźnik na strukturę zawierającą mapę dróg krajowych
+ * @param input[in,out]     - Czytnik z wczytanym wierszem polecenia
  * @return wartość @p true jeśli wykonanie zakończyło się sukcesem, wartość @p
  * false w przeciwnym wypadku  - niepoprawna składnia polecenia lub argumenty
  * */
-bool userRemoveRoute(Map *map);
+bool userRemoveRoute(Map *map, InputReader *input);
 
 /**
  * @brief Pozwala użytkownikowi automatycznie wytyczyć nową drogę krajową
  * Funkcja tworzy drogę krajową zgodnie z poleceniem zadanym przez użytkownika,
- * zawartym w tokenach uzyskanych za pomocą strtok.
+ * zawartym w tokenach uzyskanych za pomocą nextToken.
  * Funkcja automatycznie wytycza drogę z miasta o nazwie będacej pierwszym argumentem
  * do miasta o nazwie będącej drugim argumentem, zgodnie z zasadami opisanymi w
  * dokumentacji modułu operacji na mapie dróg.
  * @param map[in]           - Wskaźnik na strukturę zawierającą mapę dróg krajowych
+ * @param input[in,out]     - Czytnik z wczytanym wierszem polecenia
  * @return wartość @p true jeśli wykonanie zakończyło się sukcesem, wartość @p
  * false w przeciwnym wypadku - niepoprawna składnia polecenia lub argumenty,
  * */
-bool userNewAutoRoute(Map *map);
+bool userNewAutoRoute(Map *map, InputReader *input);
 
 /**
  * @brief Pozwala użytkownikowi wydłużyć drogę krajową
  * Funkcja wydłuża drogę krajową zgodnie z poleceniem zadanym przez użytkownika,
- * zawartym w tokenach uzyskanych za pomocą strtok.
+ * zawartym w tokenach uzyskanych za pomocą nextToken.
  * Funkcja automatycznie wytycza drogę z miasta będącym dotychczasowym końcem
  * podanej drogi krajowej do miasta o nazwie będącej drugim argumentem,
  * zgodnie z zasadami opisanymi w dokumentacji modułu operacji na mapie dróg.
  * @param map[in]           - Wskaźnik na strukturę zawierającą mapę dróg krajowych
+ * @param input[in,out]     - Czytnik z wczytanym wierszem polecenia
  * @return wartość @p true jeśli wykonanie zakończyło się sukcesem, wartość @p
  * false w przeciwnym wypadku - niepoprawna składnia polecenia lub argumenty,
  * */
-bool userExtendRoute(Map *map);
+bool userExtendRoute(Map *map, InputReader *input);
 
 #endif //DROGI_MAP_USERINTERFACE_H
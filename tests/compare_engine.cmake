@@ -0,0 +1,26 @@
+# Uruchamia program MAP na pliku INPUT bez opcji i z opcją -s ENGINE, po czym
+# porównuje oba wyjścia, standardowe i diagnostyczne.
+
+execute_process(COMMAND ${MAP}
+                INPUT_FILE ${INPUT}
+                OUTPUT_VARIABLE expectedOutput
+                ERROR_VARIABLE expectedErrors
+                RESULT_VARIABLE expectedResult)
+
+execute_process(COMMAND ${MAP} -s ${ENGINE}
+                INPUT_FILE ${INPUT}
+                OUTPUT_VARIABLE output
+                ERROR_VARIABLE errors
+                RESULT_VARIABLE result)
+
+if (NOT expectedResult EQUAL 0 OR NOT result EQUAL 0)
+    message(FATAL_ERROR "map exited with ${expectedResult} and ${result}")
+endif ()
+
+if (NOT output STREQUAL expectedOutput)
+    message(FATAL_ERROR "standard output differs with -s ${ENGINE}")
+endif ()
+
+if (NOT errors STREQUAL expectedErrors)
+    message(FATAL_ERROR "error messages differ with -s ${ENGINE}")
+endif ()
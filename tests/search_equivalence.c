@@ -0,0 +1,316 @@
+/** @file
+ * Test zgodności algorytmów wyszukiwania dróg krajowych z funkcją dkstra.
+ * Te same losowe polecenia są wykonywane na mapie używającej algorytmu
+ * djkstry i na mapach używających pozostałych algorytmów. Wyniki wszystkich
+ * poleceń i opisy wszystkich dróg krajowych muszą być takie same. Część map
+ * ma odcinki o długościach bliskich UINT_MAX, na których sumy długości dróg
+ * się przepełniają.
+ *
+ * @author Filip Bieńkowski 407686
+ * @copyright Uniwersytet Warszawski
+ */
+
+#include "map.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+/**
+ * @brief Liczba losowych map
+ */
+#define SEEDS 300
+
+/**
+ * @brief Liczba losowych map z długimi odcinkami
+ */
+#define LONG_SEEDS 150
+
+/**
+ * @brief Liczba poleceń wykonywanych na każdej mapie
+ */
+#define STEPS 400
+
+/**
+ * @brief Drogi krajowe mają numery od 1 do tej wartości
+ */
+#define MAX_ROUTE_ID 6
+
+/**
+ * @brief Rozmiar bufora na nazwę miasta
+ */
+#define NAME_LENGTH 16
+
+/**
+ * @brief Algorytm porównywany z funkcją dkstra
+ */
+struct Engine
+{
+    const char *name; ///< nazwa wypisywana przy niezgodności
+    SearchMode mode;  ///< algorytm ustawiany w mapie
+};
+typedef struct Engine Engine;
+
+/**
+ * @brief Algorytmy porównywane z funkcją dkstra
+ */
+static const Engine engines[] =
+{
+    {"bidirectional", SEARCH_BIDIRECTIONAL},
+    {"landmarks", SEARCH_LANDMARKS},
+    {"contraction", SEARCH_CONTRACTION},
+};
+
+/**
+ * @brief Liczba porównywanych algorytmów
+ */
+#define ENGINES_COUNT (sizeof(engines) / sizeof(engines[0]))
+
+/**
+ * @brief Stan generatora liczb pseudolosowych
+ */
+static uint64_t randomState;
+
+/**
+ * @brief Losuje liczbę z przedziału [0, bound)
+ * @param bound - górne ograniczenie, większe od zera
+ * @return Wylosowana liczba
+ */
+static unsigned nextRandom(unsigned bound)
+{
+    // xorshift64*, so the commands are the same on every platform
+    randomState ^= randomState >> 12;
+    randomState ^= randomState << 25;
+    randomState ^= randomState >> 27;
+
+    return (unsigned) ((randomState * 0x2545F4914F6CDD1DULL) >> 33) % bound;
+}
+
+/**
+ * @brief Losuje nazwę miasta
+ * @param name - bufor na nazwę
+ * @param cities - liczba różnych miast
+ */
+static void randomCity(char *name, unsigned cities)
+{
+    sprintf(name, "C%u", nextRandom(cities));
+}
+
+/**
+ * @brief Losuje długość odcinka
+ * @param longRoads - czy odcinki mogą mieć długości bliskie UINT_MAX
+ * @return Wylosowana długość
+ */
+static unsigned randomLength(bool longRoads)
+{
+    // short roads and few distinct years make ties, and so ambiguous
+    // routes, frequent
+    if (!longRoads || nextRandom(3) == 0) return 1 + nextRandom(3);
+
+    // two halves add up to about UINT_MAX, and a whole one overflows
+    // with any other road
+    return nextRandom(2) == 0 ? UINT_MAX - nextRandom(3)
+                              : UINT_MAX / 2 - 1 + nextRandom(3);
+}
+
+/**
+ * @brief Porównuje opisy wszystkich dróg krajowych dwóch map
+ * @param reference - mapa używająca funkcji dkstra
+ * @param tested - mapa używająca sprawdzanego algorytmu
+ * @param engine - nazwa sprawdzanego algorytmu
+ * @return true, jeśli opisy są takie same; w przeciwnym wypadku false
+ */
+static bool sameRoutes(Map *reference, Map *tested, const char *engine)
+{
+    bool same = true;
+
+    for (unsigned id = 1; same && id <= MAX_ROUTE_ID; ++id)
+    {
+        char const *expected = getRouteDescription(reference, id);
+        char const *actual = getRouteDescription(tested, id);
+
+        if (expected == NULL || actual == NULL)
+        {
+            fprintf(stderr, "out of memory\n");
+            same = false;
+        }
+        else if (strcmp(expected, actual) != 0)
+        {
+            fprintf(stderr, "%s: route %u is \"%s\", expected \"%s\"\n",
+                    engine, id, actual, expected);
+            same = false;
+        }
+
+        free((void *) expected);
+        free((void *) actual);
+    }
+
+    return same;
+}
+
+/**
+ * @brief Wykonuje losowe polecenie na wszystkich mapach
+ * @param maps - mapy; pierwsza używa funkcji dkstra, kolejne algorytmów
+ * z tablicy engines
+ * @param cities - liczba różnych miast
+ * @param longRoads - czy odcinki mogą mieć długości bliskie UINT_MAX
+ * @return true, jeśli wszystkie mapy dały ten sam wynik; w przeciwnym
+ * wypadku false
+ */
+static bool runCommand(Map **maps, unsigned cities, bool longRoads)
+{
+    char cityA[NAME_LENGTH];
+    char cityB[NAME_LENGTH];
+    randomCity(cityA, cities);
+    randomCity(cityB, cities);
+
+    unsigned length = randomLength(longRoads);
+    int year = 1 + (int) nextRandom(4);
+    unsigned routeId = 1 + nextRandom(MAX_ROUTE_ID);
+    unsigned command = nextRandom(100);
+
+    bool results[ENGINES_COUNT + 1];
+    for (unsigned i = 0; i <= ENGINES_COUNT; ++i)
+    {
+        if (command < 35)
+        {
+            results[i] = addRoad(maps[i], cityA, cityB, length, year);
+        }
+        else if (command < 45)
+        {
+            results[i] = repairRoad(maps[i], cityA, cityB, year + 4);
+        }
+        else if (command < 60)
+        {
+            results[i] = removeRoad(maps[i], cityA, cityB);
+        }
+        else if (command < 80)
+        {
+            results[i] = newRoute(maps[i], routeId, cityA, cityB);
+        }
+        else if (command < 92)
+        {
+            results[i] = extendRoute(maps[i], routeId, cityA);
+        }
+        else
+        {
+            results[i] = removeRoute(maps[i], routeId);
+        }
+    }
+
+    bool same = true;
+    for (unsigned i = 1; i <= ENGINES_COUNT; ++i)
+    {
+        if (results[i] != results[0])
+        {
+            fprintf(stderr, "%s: command %u (%s, %s, route %u) returned %d\n",
+                    engines[i - 1].name, command, cityA, cityB, routeId,
+                    results[i]);
+            same = false;
+        }
+        else if (!sameRoutes(maps[0], maps[i], engines[i - 1].name))
+        {
+            same = false;
+        }
+    }
+
+    return same;
+}
+
+/**
+ * @brief Tworzy mapy dla funkcji dkstra i dla wszystkich algorytmów
+ * @param maps - tablica na mapy
+ * @return true, jeśli się udało; w przeciwnym wypadku false
+ */
+static bool newMaps(Map **maps)
+{
+    for (unsigned i = 0; i <= ENGINES_COUNT; ++i)
+    {
+        maps[i] = newMap();
+        if (maps[i] == NULL)
+        {
+            fprintf(stderr, "out of memory\n");
+            return false;
+        }
+        setSearchMode(maps[i], i == 0 ? SEARCH_DIJKSTRA : engines[i - 1].mode);
+    }
+
+    return true;
+}
+
+/**
+ * @brief Usuwa mapy utworzone przez newMaps
+ * @param maps - mapy
+ */
+static void deleteMaps(Map **maps)
+{
+    for (unsigned i = 0; i <= ENGINES_COUNT; ++i)
+    {
+        deleteMap(maps[i]);
+    }
+}
+
+/**
+ * @brief Sprawdza drogę, której długość mieści się w typie unsigned, choć
+ * krótsza po przepełnieniu droga przez B ma długość większą niż UINT_MAX
+ * @return true, jeśli wszystkie algorytmy wyznaczyły drogę A;Y;C;
+ * w przeciwnym wypadku false
+ */
+static bool checkOverflowingDetour(void)
+{
+    Map *maps[ENGINES_COUNT + 1];
+    if (!newMaps(maps)) return false;
+
+    bool same = true;
+    for (unsigned i = 0; i <= ENGINES_COUNT; ++i)
+    {
+        const char *engine = i == 0 ? "dijkstra" : engines[i - 1].name;
+        bool built = addRoad(maps[i], "A", "B", UINT_MAX, 2000) &&
+                     addRoad(maps[i], "B", "C", 10, 2000) &&
+                     addRoad(maps[i], "A", "Y", 4294967000u, 2000) &&
+                     addRoad(maps[i], "Y", "C", 290, 2000) &&
+                     newRoute(maps[i], 1, "A", "C");
+
+        char const *description = getRouteDescription(maps[i], 1);
+        if (!built || description == NULL ||
+            strcmp(description, "1;A;4294967000;2000;Y;290;2000;C") != 0)
+        {
+            fprintf(stderr, "%s: route A C is \"%s\"\n", engine,
+                    description == NULL ? "" : description);
+            same = false;
+        }
+        free((void *) description);
+    }
+
+    deleteMaps(maps);
+    return same;
+}
+
+int main(void)
+{
+    unsigned failures = checkOverflowingDetour() ? 0 : 1;
+
+    for (unsigned seed = 0; seed < SEEDS + LONG_SEEDS && failures == 0; ++seed)
+    {
+        randomState = 0x9E3779B97F4A7C15ULL * (seed + 1);
+        unsigned cities = 6 + seed % 30;
+        bool longRoads = seed >= SEEDS;
+
+        Map *maps[ENGINES_COUNT + 1];
+        if (!newMaps(maps)) return EXIT_FAILURE;
+
+        for (unsigned step = 0; step < STEPS && failures == 0; ++step)
+        {
+            if (!runCommand(maps, cities, longRoads))
+            {
+                fprintf(stderr, "seed %u, step %u\n", seed, step);
+                failures++;
+            }
+        }
+
+        deleteMaps(maps);
+    }
+
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}